@@ -1,14 +1,32 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "pico/stdlib.h"
-#include "hardware/adc.h"
-#include "hardware/i2c.h"
-#include "hardware/pwm.h"
-#include "hardware/clocks.h"
 #include "lib/ssd1306.h"
 #include "lib/graphics.h"
+#include "lib/sensor_scan.h"
+#include "lib/seqlock.h"
+#include "lib/spsc_ring.h"
+#include "lib/temperature.h"
+#include "lib/history.h"
+#include "lib/stream_stats.h"
+#include "lib/events.h"
+#include "lib/widgets.h"
+#include "lib/hal.h"
+#include "lib/probe.h"
 #include "string.h"
 
+// Com MONITOR_APP_ONLY (simulador em sim/, benchmarks em bench/) compila só a
+// parte portável: aquisição, estatísticas, alertas e telas, sobre a HAL. USB,
+// Modbus, flash e o laço principal ficam de fora.
+#ifndef MONITOR_APP_ONLY
+#include "lib/calibration.h"
+#include "lib/flash_log.h"
+#include "lib/usb_stream.h"
+#include "lib/display_mirror.h"
+#include "lib/modbus_rtu.h"
+#include "lib/mem_usage.h"
+#endif
+
 #define I2C_PORT i2c1
 #define I2C_SDA 14
 #define I2C_SCL 15
@@ -16,7 +34,6 @@
 
 #define TEMP_SENSOR_PIN 26   // GPIO para sensor de temperatura
 #define SAMPLE_INTERVAL 1000 // Intervalo de amostragem em ms
-#define MAX_SAMPLES 100      // Número máximo de amostras para o gráfico
 
 // Adicionar estas definições no início do arquivo
 #define GRAPH_Y_START 20
@@ -26,19 +43,14 @@
 #define BUTTON_A_PIN 5 // GPIO para o botão A
 #define BUTTON_B_PIN 6 // GPIO para o botão B
 
-// Buffer circular para armazenar as temperaturas
-float temp_history[MAX_SAMPLES];
-int current_index = 0;
-int num_samples = 0;
-
 // Atualizar a estrutura do gráfico
 Graph graph = {
     .x_offset = MARGIN_LEFT,
     .y_offset = 5,
     .width = DISPLAY_WIDTH - MARGIN_LEFT - 5,
     .height = GRAPH_HEIGHT,
-    .y_min = 0,
-    .y_max = 50,
+    .y_min = TEMP_CENTI(0.0f),
+    .y_max = TEMP_CENTI(50.0f),
     .y_pixels = GRAPH_HEIGHT,
     .x_divisions = 5,
     .y_divisions = 4};
@@ -55,7 +67,9 @@ typedef enum
     STATE_HISTORY,
     STATE_CONFIG,
     STATE_STATS,
-    STATE_ALERTS // Novo estado
+    STATE_ALERTS, // Novo estado
+    STATE_DIAG,
+    STATE_COUNT
 } SystemState;
 
 // Opções do menu principal
@@ -66,21 +80,13 @@ typedef enum
     MENU_CONFIG,
     MENU_STATS,
     MENU_ALERTS, // Nova opção
+    MENU_DIAG,
     MENU_COUNT
 } MenuItem;
 
-// Estrutura para armazenar estatísticas
-typedef struct
-{
-    float min_temp;
-    float max_temp;
-    float avg_temp;
-} TempStats;
-
 // Variáveis globais do sistema
 SystemState current_state = STATE_SPLASH;
 MenuItem selected_menu_item = MENU_MONITOR;
-TempStats temp_stats = {.min_temp = 100.0f, .max_temp = -100.0f, .avg_temp = 0.0f};
 uint32_t splash_start_time = 0;
 
 // Variáveis globais para controle de estado
@@ -88,7 +94,7 @@ volatile bool button_a_pressed = false;
 volatile bool button_b_pressed = false;
 
 // Adicione estas definições no início do arquivo, após os outros #defines
-#define HISTORY_SIZE 128           // Tamanho baseado na largura do display
+#define HISTORY_SIZE HISTORY_MAX_TIER_SIZE // Maior nível do histórico (largura do display)
 #define DISPLAY_LINES 4            // Número de linhas no modo histórico
 #define TEMP_READ_INTERVAL_MS 1000 // Intervalo de 1 segundo
 
@@ -96,46 +102,172 @@ volatile bool button_b_pressed = false;
 #define ADC_CHANNEL_TEMP 0   // Canal 0 para o sensor de temperatura
 #define ADC_CHANNEL_SCROLL 1 // Canal 1 para o controle de rolagem
 
-// Estrutura para armazenar o histórico
-struct
+// Sobreamostragem de cada canal: 2^8 = 256 conversões por leitura, numa
+// rajada do ADC somada pelo DMA
+#define ADC_OVERSAMPLE_LOG2 8
+
+// Tabela de sensores varridos a cada período. Para vários painéis, ligue um
+// multiplexador analógico de 16 vias em cada entrada livre do ADC (as linhas
+// de seleção são compartilhadas) e liste os canais agrupados por endereço:
+//   {.adc_input = 0, .mux_address = 0}, {.adc_input = 2, .mux_address = 0},
+//   {.adc_input = 0, .mux_address = 1}, {.adc_input = 2, .mux_address = 1}, ...
+// Com as entradas 0 e 2 multiplexadas são 32 canais; cada um custa uma rajada
+// de 256 conversões (~0,5 ms) mais a acomodação, bem abaixo do período de 1 s.
+// Na RAM cada canal ocupa ~4,5 KB (CHANNEL_MEMORY_BYTES, quase tudo histórico
+// e estatísticas): os 32 somam ~146 KB, dentro de CHANNEL_RAM_BUDGET, que
+// comportaria até 35.
+#define SENSOR_CHANNEL_COUNT 1
+#define SENSOR_CHANNEL_MAX 32 // Duas entradas com multiplexador de 16 vias
+_Static_assert(SENSOR_CHANNEL_COUNT <= SENSOR_CHANNEL_MAX, "mais canais que SENSOR_CHANNEL_MAX");
+#define MUX_SETTLE_US 20
+
+const sensor_channel_t sensor_channels[SENSOR_CHANNEL_COUNT] = {
+    {.adc_input = ADC_CHANNEL_TEMP, .mux_address = SENSOR_NO_MUX},
+};
+
+const sensor_mux_t sensor_mux = {
+    .select_pins = {16, 17, 18, 19},
+    .select_bits = 4,
+    .settle_us = MUX_SETTLE_US};
+
+const hal_sensor_config_t sensor_config = {
+    .channels = sensor_channels,
+    .channel_count = SENSOR_CHANNEL_COUNT,
+    .mux = &sensor_mux,
+    .adc_input = ADC_CHANNEL_TEMP,
+    .oversample_log2 = ADC_OVERSAMPLE_LOG2,
+    .interval_ms = TEMP_READ_INTERVAL_MS};
+
+// Canal exibido nas telas de monitor, histórico e estatísticas
+volatile uint8_t selected_channel = 0;
+
+// Histórico em níveis (1 s, 1 min, 15 min, 1 h), em centésimos de grau.
+// Cada canal tem o seu bloco contíguo. Escrito só pelo núcleo 1, sob
+// history_lock; a interface lê por history_snapshot().
+history_channel_t channel_history[SENSOR_CHANNEL_COUNT];
+
+seqlock_t history_lock;
+
+// Posição de rolagem da tela de histórico (apenas núcleo 0)
+int history_scroll_position = 0;
+
+// Nível do histórico exibido no gráfico e na lista (apenas núcleo 0)
+uint8_t history_zoom = HISTORY_TIER_SECONDS;
+const char *const history_zoom_labels[HISTORY_TIER_COUNT] = {"1s", "1m", "15m", "1h"};
+
+// Variável para controle de atualização do display (apenas núcleo 0)
+bool new_temperature_available = false;
+
+// Eventos que acordam o laço principal (lib/events)
+#define EVENT_BUTTON (1u << 0)  // Botão A ou B (IRQ do GPIO)
+#define EVENT_SAMPLE (1u << 1)  // Varredura entregue pelo núcleo 1
+#define EVENT_DISPLAY (1u << 2) // Fim do DMA do quadro do display
+#define EVENT_SERIAL (1u << 3)  // Caracteres recebidos pela USB
+#define EVENT_CONFIG (1u << 4)  // Limites de alerta alterados pelo Modbus
+
+// Instrumentação (lib/probe.h): seções medidas, exibidas na tela Diag e
+// no comando "diag"
+typedef enum
 {
-    float temperatures[HISTORY_SIZE];
-    int count;
-    int newest_index;
-    int scroll_position;
-    float min_temp;
-    float max_temp;
-} temperature_history = {
-    .temperatures = {0},
-    .count = 0,
-    .newest_index = 0,
-    .scroll_position = 0,
-    .min_temp = 100.0f,
-    .max_temp = 0.0f};
-
-// Variável para controle de atualização do display
-volatile bool new_temperature_available = false;
+    PROBE_SCAN_ISR,    // Processamento da varredura na IRQ do núcleo 1 (ciclos)
+    PROBE_SCAN_JITTER, // Desvio do período entre varreduras (us)
+    PROBE_FLUSH_CALL,  // Montagem e início do envio do quadro (ciclos)
+    PROBE_FLUSH_BUS,   // Do início do envio ao fim do DMA do display (us)
+    PROBE_FRAME,       // Período entre quadros enviados (us)
+    PROBE_LOOP,        // Período entre despertares do laço principal (us)
+    PROBE_RENDER,      // Desenho de cada tela (ciclos), indexado pelo estado
+    PROBE_COUNT = PROBE_RENDER + STATE_COUNT
+} ProbeId;
+
+typedef struct
+{
+    const char *name;
+    bool cycles; // Unidade: ciclos de hal_cycles() ou us
+} ProbeInfo;
+
+const ProbeInfo probe_info[PROBE_COUNT] = {
+    [PROBE_SCAN_ISR] = {"scan_isr", true},
+    [PROBE_SCAN_JITTER] = {"scan_jitter", false},
+    [PROBE_FLUSH_CALL] = {"flush_call", true},
+    [PROBE_FLUSH_BUS] = {"flush_bus", false},
+    [PROBE_FRAME] = {"frame", false},
+    [PROBE_LOOP] = {"loop", false},
+    [PROBE_RENDER + STATE_SPLASH] = {"render_splash", true},
+    [PROBE_RENDER + STATE_MENU] = {"render_menu", true},
+    [PROBE_RENDER + STATE_MONITOR] = {"render_monitor", true},
+    [PROBE_RENDER + STATE_HISTORY] = {"render_history", true},
+    [PROBE_RENDER + STATE_CONFIG] = {"render_config", true},
+    [PROBE_RENDER + STATE_STATS] = {"render_stats", true},
+    [PROBE_RENDER + STATE_ALERTS] = {"render_alerts", true},
+    [PROBE_RENDER + STATE_DIAG] = {"render_diag", true},
+};
+
+probe_stat_t probes[PROBE_COUNT];
+
+// Eventos do anel de rastreio
+typedef enum
+{
+    TRACE_SCAN,       // Varredura processada (arg: contador, 16 bits)
+    TRACE_BUTTON,     // Botão aceito (arg: GPIO)
+    TRACE_RENDER,     // Tela desenhada (arg: estado)
+    TRACE_FLUSH,      // Quadro enviado (arg: bytes)
+    TRACE_FLUSH_DONE, // Fim do DMA do display
+    TRACE_COUNT
+} TraceEvent;
+
+const char *const trace_names[TRACE_COUNT] = {"scan", "button", "render", "flush", "flush_done"};
+
+#if PROBE_ENABLED
+volatile uint32_t display_flush_start_us; // Início do envio em curso (PROBE_FLUSH_BUS)
+#endif
+
+// Leitura do joystick (analógico, sem IRQ) nas telas que o usam
+#define JOYSTICK_POLL_MS 50
+
+// Registro de uma varredura enviado do núcleo 1 ao núcleo 0
+typedef struct
+{
+    uint32_t sequence;
+    uint16_t adc_q4[SENSOR_CHANNEL_COUNT]; // Leituras em Q12.4
+} SampleRecord;
+
+#define SAMPLE_RING_SIZE 16 // Potência de 2
+SampleRecord sample_ring_buffer[SAMPLE_RING_SIZE];
+spsc_ring_t sample_ring;
+
+// Registro do arquivo na flash: um minuto fechado de todos os canais, só
+// campos temp_centi_t. O núcleo 1 fecha o minuto; o núcleo 0 comprime e
+// grava (lib/flash_log).
+typedef struct
+{
+    history_record_t channels[SENSOR_CHANNEL_COUNT];
+} ArchiveRecord;
+
+#define ARCHIVE_FIELDS (sizeof(ArchiveRecord) / sizeof(temp_centi_t))
+#define ARCHIVE_RECORDS_PER_DAY (24 * 60)
+#define ARCHIVE_RING_SIZE 8 // Potência de 2; minutos de folga do núcleo 0
+ArchiveRecord archive_ring_buffer[ARCHIVE_RING_SIZE];
+spsc_ring_t archive_ring;
 
 // Definições para o condicionamento do gráfico
 #define GRAPH_Y_MIN 0  // Valor mínimo do eixo Y (pixels)
 #define GRAPH_Y_MAX 52 // Valor máximo do eixo Y (pixels)
+#define GRAPH_POINTS 116           // Registros exibidos (x de 127 a 12)
+#define GRAPH_MIN_SPAN TEMP_CENTI(2.0f) // Faixa mínima do eixo Y no ajuste automático
 #define TEMP_MIN_SENSOR 0
 #define TEMP_MAX_SENSOR 100
 
 uint16_t adc_value_x;
-char TEMP_REAL[5];
+char TEMP_REAL[TEMP_STR_SIZE];
 // Limites de temperatura ajustáveis
 struct
 {
-    float temp_min;    // Temperatura mínima para escala
-    float temp_max;    // Temperatura máxima para escala
-    float current_min; // Menor temperatura registrada
-    float current_max; // Maior temperatura registrada
+    temp_centi_t temp_min;    // Temperatura mínima para escala
+    temp_centi_t temp_max;    // Temperatura máxima para escala
 } temp_scale = {
-    .temp_min = 20.0f, // Limite inferior inicial
-    .temp_max = 40.0f, // Limite superior inicial
-    .current_min = 100.0f,
-    .current_max = 0.0f};
+    .temp_min = TEMP_CENTI(20.0f), // Limite inferior inicial
+    .temp_max = TEMP_CENTI(40.0f), // Limite superior inicial
+};
 
 #define ADC_MAX_VALUE 4095 // Valor máximo do ADC (12 bits)
 #define ADC_MID_VALUE 2047 // Valor médio do ADC
@@ -152,18 +284,138 @@ typedef enum
 // Estrutura para configuração de alertas
 typedef struct
 {
-    float temp_normal_max;    // Limite superior para operação normal
-    float temp_attention_max; // Limite superior para atenção
-    float temp_urgent_max;    // Limite superior para urgente
-    AlertType current_alert;  // Estado atual do alerta
+    temp_centi_t temp_normal_max;    // Limite superior para operação normal
+    temp_centi_t temp_attention_max; // Limite superior para atenção
+    temp_centi_t temp_urgent_max;    // Limite superior para urgente
 } AlertConfig;
     
-// Inicialização da configuração de alertas
+// Inicialização da configuração de alertas. Escrita só pela IRQ do Modbus
+// (núcleo 0), sob config_lock; leitores usam alert_config_snapshot(), de
+// modo que a varredura nunca vê limites de escritas diferentes misturados.
 AlertConfig alert_config = {
-    .temp_normal_max = 55.0f,    // Operação normal até 45°C
-    .temp_attention_max = 65.0f, // Atenção até 65°C
-    .temp_urgent_max = 80.0f,    // Urgente acima de 65°C
-    .current_alert = ALERT_NORMAL};
+    .temp_normal_max = TEMP_CENTI(55.0f),    // Operação normal até 45°C
+    .temp_attention_max = TEMP_CENTI(65.0f), // Atenção até 65°C
+    .temp_urgent_max = TEMP_CENTI(80.0f)};   // Urgente acima de 65°C
+seqlock_t config_lock;
+
+void alert_config_snapshot(AlertConfig *out)
+{
+    uint32_t seq;
+    do
+    {
+        seq = seqlock_read_begin(&config_lock);
+        *out = alert_config;
+    } while (seqlock_read_retry(&config_lock, seq));
+}
+
+// Estado publicado pelo núcleo 1 a cada varredura (estrutura de vetores).
+// Escrito só pelo núcleo 1, sob status_lock; leitores usam status_snapshot().
+typedef struct
+{
+    uint16_t latest_adc_q4[SENSOR_CHANNEL_COUNT];    // Última leitura do ADC, Q12.4
+    temp_centi_t latest_temp[SENSOR_CHANNEL_COUNT];  // Última temperatura
+    AlertType channel_alert[SENSOR_CHANNEL_COUNT];   // Alerta individual de cada canal
+    AlertType current_alert;                         // Pior estado entre todos os canais
+    uint32_t scans;                                  // Varreduras publicadas
+} SystemStatus;
+
+SystemStatus system_status = {.current_alert = ALERT_NORMAL};
+seqlock_t status_lock;
+
+// Estatísticas incrementais por canal (total e janelas de 1 min, 15 min e
+// 1 h). Escritas só pelo núcleo 1, sob stats_lock; leitores usam
+// stats_snapshot().
+stream_stats_t channel_stats[SENSOR_CHANNEL_COUNT];
+seqlock_t stats_lock;
+
+// Janela exibida na tela de estatísticas (apenas núcleo 0)
+uint8_t stats_window = STATS_WINDOW_1MIN;
+const char *const stats_window_labels[STATS_WINDOW_COUNT + 1] = {"1 min", "15 min", "1 h", "total"};
+
+// Memória de estado por canal: histórico, estatísticas, estado publicado e varredura
+#define CHANNEL_MEMORY_BYTES (sizeof(history_channel_t) + sizeof(stream_stats_t) +  \
+                              sizeof(uint16_t) + sizeof(temp_centi_t) +            \
+                              sizeof(AlertType) +                                   \
+                              sizeof(uint16_t) + SENSOR_SCAN_BYTES_PER_CHANNEL)
+
+// Orçamento de RAM do estado dos canais. Dos 264 KB do RP2040 ficam cerca de
+// 100 KB para o programa copiado para a RAM (copy_to_ram), as pilhas e os
+// buffers de display, USB e flash; tools/mem_report.py mostra o uso real
+// depois de cada link.
+#define CHANNEL_RAM_BUDGET (160 * 1024)
+_Static_assert(CHANNEL_MEMORY_BYTES * SENSOR_CHANNEL_MAX <= CHANNEL_RAM_BUDGET,
+               "SENSOR_CHANNEL_MAX canais excedem CHANNEL_RAM_BUDGET");
+
+// Cópia consistente do estado publicado, sem bloquear o núcleo 1
+void status_snapshot(SystemStatus *out)
+{
+    uint32_t seq;
+    do
+    {
+        seq = seqlock_read_begin(&status_lock);
+        *out = system_status;
+    } while (seqlock_read_retry(&status_lock, seq));
+}
+
+// Resumo de uma janela das estatísticas de um canal; falso sem amostras
+bool stats_snapshot(uint8_t channel, uint8_t window, stream_stats_summary_t *out)
+{
+    uint32_t seq;
+    bool valid;
+    do
+    {
+        seq = seqlock_read_begin(&stats_lock);
+        valid = stream_stats_summary(&channel_stats[channel], window, out);
+    } while (seqlock_read_retry(&stats_lock, seq));
+    return valid;
+}
+
+// Copia até `max` registros de um nível do histórico de um canal, do mais
+// novo para o mais antigo. Se `span` não for nulo, recebe também o resumo
+// (mínimo, máximo e média) dos primeiros `span_length` registros copiados,
+// obtido pelo índice do nível em O(log n).
+int history_snapshot(uint8_t channel, uint8_t tier, history_record_t *out, int max,
+                     history_record_t *span, int span_length)
+{
+    const history_channel_t *history = &channel_history[channel];
+    uint32_t seq;
+    int count;
+    do
+    {
+        seq = seqlock_read_begin(&history_lock);
+        count = history_count(history, tier);
+        if (count > max)
+            count = max;
+        for (int i = 0; i < count; i++)
+        {
+            out[i] = history_get(history, tier, i);
+        }
+        if (span)
+        {
+            history_range(history, tier, 0, span_length, span);
+        }
+    } while (seqlock_read_retry(&history_lock, seq));
+    return count;
+}
+
+// Médias das linhas visíveis da tela de histórico, a partir de `from_age`.
+// Devolve o total de registros do nível.
+int history_lines(uint8_t channel, uint8_t tier, int from_age, temp_centi_t *out, int max)
+{
+    const history_channel_t *history = &channel_history[channel];
+    uint32_t seq;
+    int total;
+    do
+    {
+        seq = seqlock_read_begin(&history_lock);
+        total = history_count(history, tier);
+        for (int i = 0; i < max && from_age + i < total; i++)
+        {
+            out[i] = history_get(history, tier, from_age + i).mean;
+        }
+    } while (seqlock_read_retry(&history_lock, seq));
+    return total;
+}
 
 // Definições dos pinos do LED RGB
 
@@ -192,25 +444,27 @@ RGB_LED_Control rgb_led;
 
 // Função para inicializar o LED RGB
 
+// Nível PWM baseado na intensidade, calculado em tempo de compilação.
+// Garante que a intensidade está entre 0 e 1.
+// Como os LEDs são ativos em nível baixo:
+// - PWM_WRAP = LED desligado
+// - 0 = LED com brilho máximo
+static const uint16_t led_pwm_level =
+    (uint16_t)(PWM_WRAP * ((LED_INTENSITY < 0.0f) ? 0.0f : (LED_INTENSITY > 1.0f) ? 1.0f
+                                                                                  : LED_INTENSITY));
+
 // Função para calcular o nível PWM baseado na intensidade
 uint16_t get_pwm_level(void)
 {
-    // Garante que a intensidade está entre 0 e 1
-    float intensity = (LED_INTENSITY < 0.0f) ? 0.0f : (LED_INTENSITY > 1.0f) ? 1.0f
-                                                                             : LED_INTENSITY;
-
-    // Como os LEDs são ativos em nível baixo:
-    // - PWM_WRAP = LED desligado
-    // - 0 = LED com brilho máximo
-    return (uint16_t)(PWM_WRAP * intensity);
+    return led_pwm_level;
 }
 
 void pwm_set_duty(uint gpio, uint16_t value)
 {
-    pwm_set_gpio_level(gpio, value);
+    hal_led_set(gpio, value);
 }
 
-// Função para atualizar o LED baseado no status
+// Função para atualizar o LED baseado no status (só o núcleo 1 escreve nos LEDs)
 void update_led_status(AlertType alert_status)
 {
     uint16_t pwm_level = get_pwm_level();
@@ -248,13 +502,15 @@ void gpio_callback(uint gpio, uint32_t events)
     // Debounce por software
     static uint32_t last_interrupt_time_a = 0;
     static uint32_t last_interrupt_time_b = 0;
-    uint32_t interrupt_time = time_us_32();
+    uint32_t interrupt_time = hal_time_us();
 
     if (gpio == BUTTON_A_PIN)
     {
         if (interrupt_time - last_interrupt_time_a > 200000)
         { // 200ms debounce
             button_a_pressed = true;
+            PROBE_TRACE(TRACE_BUTTON, gpio);
+            events_post(EVENT_BUTTON);
         }
         last_interrupt_time_a = interrupt_time;
     }
@@ -263,555 +519,1786 @@ void gpio_callback(uint gpio, uint32_t events)
         if (interrupt_time - last_interrupt_time_b > 200000)
         { // 200ms debounce
             button_b_pressed = true;
+            PROBE_TRACE(TRACE_BUTTON, gpio);
+            events_post(EVENT_BUTTON);
         }
         last_interrupt_time_b = interrupt_time;
     }
 }
 
-// Funções para desenhar as diferentes telas
-
-float map_value(float x, float x1, float x2, float y1, float y2)
-{
-    return y1 + ((x - x1) * (y2 - y1)) / (x2 - x1);
-}
+// Telas em widgets retidos (lib/widgets.h): a camada estática é desenhada
+// uma vez ao entrar na tela e cada quadro só atualiza os valores ligados
 
-void draw_splash_screen(ssd1306_t *ssd)
+void draw_splash_static(ssd1306_t *ssd)
 {
-    ssd1306_fill(ssd, false);
     ssd1306_line(ssd, 0, 0, 128, 0, true); // desenha uma linha horizontal de (6,5) até (120,5)
-    ssd1306_line(ssd, 0, 0, 128, 0, true); // desenha uma linha horizontal de (6,5) até (120,5)
-    ssd1306_draw_string(ssd, " System Monitor", 4, 10);
-    ssd1306_draw_string(ssd, "Painel Solar", 20, 20);
-    ssd1306_draw_string(ssd, "Versao 1.0", 25, 40);
-    ssd1306_draw_string(ssd, " A:Menu B:Entrar", 0, 55);
 }
 
-#define MENU_ITEMS_VISIBLE 4 // Número máximo de itens visíveis no display
+const widget_label_t splash_labels[] = {
+    {4, 10, " System Monitor"},
+    {20, 20, "Painel Solar"},
+    {25, 40, "Versao 1.0"},
+    {0, 55, " A:Menu B:Entrar"},
+};
 
-void draw_menu_screen(ssd1306_t *ssd)
-{
-    ssd1306_fill(ssd, false);
-    const char *menu_items[] = {"Monitor", "Historico", "Config", "Stats", "Alertas"};
+const widget_screen_t splash_screen = {
+    .labels = splash_labels,
+    .label_count = count_of(splash_labels),
+    .draw_static = draw_splash_static,
+};
 
-    // Calcula o primeiro item visível baseado na seleção atual
-    int first_visible = 0;
-    if (selected_menu_item >= MENU_ITEMS_VISIBLE)
-    {
-        first_visible = selected_menu_item - MENU_ITEMS_VISIBLE + 1;
-    }
+#define MENU_ITEMS_VISIBLE 4 // Número máximo de itens visíveis no display
 
-    // Desenha apenas os itens visíveis
-    for (int i = 0; i < MENU_ITEMS_VISIBLE && (i + first_visible) < MENU_COUNT; i++)
-    {
-        char line[32];
-        int current_item = i + first_visible;
+const char *const menu_items[MENU_COUNT] = {"Monitor", "Historico", "Config", "Stats", "Alertas", "Diag"};
 
-        // Adiciona indicadores de scroll se necessário
-        if (first_visible > 0 && i == 0)
-        {
-            ssd1306_draw_string(ssd, "^", 60, 0); // Seta para cima
-        }
-        if ((first_visible + MENU_ITEMS_VISIBLE) < MENU_COUNT && i == (MENU_ITEMS_VISIBLE - 1))
-        {
-            ssd1306_draw_string(ssd, "v", 60, 45); // Seta para baixo
-        }
+widget_list_t menu_list = WIDGET_LIST(10, 0, WIDTH - 10, menu_items, MENU_COUNT, MENU_ITEMS_VISIBLE, 15);
 
-        snprintf(line, sizeof(line), "%s%s",
-                 (current_item == selected_menu_item) ? "> " : "  ",
-                 menu_items[current_item]);
-        ssd1306_draw_string(ssd, line, 10, i * 15);
-    }
+void bind_menu_screen(void)
+{
+    widget_list_select(&menu_list, selected_menu_item);
 }
 
-// Função para ler e condicionar o sinal do joystick
-float read_joystick_value()
+widget_t *const menu_widgets[] = {&menu_list.base};
+
+const widget_screen_t menu_screen = {
+    .bind = bind_menu_screen,
+    .widgets = menu_widgets,
+    .widget_count = count_of(menu_widgets),
+};
+
+// Última leitura de um canal no formato Q12.4 (com fração da sobreamostragem)
+uint16_t channel_adc_q4(uint8_t channel)
 {
-    adc_select_input(0);       // Seleciona o canal ADC para o pino 26
-    uint16_t raw = adc_read(); // Leitura do ADC de 12 bits (0-4095)
+    uint32_t seq;
+    uint16_t value;
+    do
+    {
+        seq = seqlock_read_begin(&status_lock);
+        value = system_status.latest_adc_q4[channel];
+    } while (seqlock_read_retry(&status_lock, seq));
+    return value;
+}
 
-    // Condicionamento do sinal:
-    // Mapeia a leitura do ADC (0-4095) para o range desejado (0-52)
-    float mapped_value = (float)raw * 52.0f / 4095.0f;
+// Função para adicionar uma varredura (um valor por canal) ao histórico
+void add_temperature_to_history(const temp_centi_t *temps)
+{
+    ArchiveRecord archive;
+    bool minute_closed = false;
 
-    // Garante que o valor está dentro dos limites
-    if (mapped_value < 0.0f)
-        mapped_value = 0.0f;
-    if (mapped_value > 52.0f)
-        mapped_value = 52.0f;
+    seqlock_write_begin(&history_lock);
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        // Todos os canais fecham o minuto na mesma varredura
+        if (history_add(&channel_history[ch], temps[ch]) >= HISTORY_TIER_MINUTES)
+        {
+            archive.channels[ch] = history_get(&channel_history[ch], HISTORY_TIER_MINUTES, 0);
+            minute_closed = true;
+        }
+    }
+    seqlock_write_end(&history_lock);
 
-    return mapped_value;
+    // Minuto fechado vai para o arquivo na flash, gravado pelo núcleo 0
+    if (minute_closed)
+        spsc_ring_push(&archive_ring, &archive);
 }
 
-// Função para adicionar nova temperatura ao histórico
-void add_temperature_to_history(float temp)
+// Função modificada para debug
+// Joystick na tela de histórico: uma linha por leitura enquanto inclinado.
+// Verdadeiro se a posição mudou.
+bool update_history_scroll(void)
 {
-    temperature_history.temperatures[temperature_history.newest_index] = temp;
-    temperature_history.newest_index = (temperature_history.newest_index + 1) % HISTORY_SIZE;
-    if (temperature_history.count < HISTORY_SIZE)
+    uint16_t scroll_raw = hal_adc_read_aux(ADC_CHANNEL_SCROLL);
+    int count = history_lines(selected_channel, history_zoom, 0, NULL, 0);
+
+    if (scroll_raw > 3000 && history_scroll_position > 0)
+    {
+        history_scroll_position--;
+        return true;
+    }
+    if (scroll_raw < 1000 && history_scroll_position < (count - DISPLAY_LINES))
     {
-        temperature_history.count++;
+        history_scroll_position++;
+        return true;
     }
+    return false;
 }
 
-// Função modificada para debug
-void draw_history_screen(ssd1306_t *ssd)
+void draw_title_rule(ssd1306_t *ssd)
 {
-    ssd1306_fill(ssd, false);
-    ssd1306_draw_string(ssd, "Historico Temp.", 5, 0);
     ssd1306_line(ssd, 0, 10, 128, 10, true);
+}
 
-    // Debug: mostra quantidade de temperaturas armazenadas
-    char debug_str[16];
-    snprintf(debug_str, sizeof(debug_str), "Total: %d", temperature_history.count);
-    ssd1306_draw_string(ssd, debug_str, 5, 15);
+const widget_label_t history_labels[] = {{5, 0, "Historico Temp."}};
 
-    // Lê o valor do joystick para rolagem
-    adc_select_input(ADC_CHANNEL_SCROLL);
-    uint16_t scroll_raw = adc_read();
+widget_value_t history_total = WIDGET_VALUE(5, 15, 14);
+widget_value_t history_rows[DISPLAY_LINES] = {
+    WIDGET_VALUE(5, 27, 14),
+    WIDGET_VALUE(5, 37, 14),
+    WIDGET_VALUE(5, 47, 14),
+    WIDGET_VALUE(5, 57, 14),
+};
+widget_value_t history_up = WIDGET_VALUE(120, 15, 1);
+widget_value_t history_down = WIDGET_VALUE(120, 50, 1);
 
-    // Ajusta a posição de rolagem baseado no joystick
-    if (scroll_raw > 3000)
-    {
-        if (temperature_history.scroll_position > 0)
-        {
-            temperature_history.scroll_position--;
-        }
-    }
-    else if (scroll_raw < 1000)
+void bind_history_screen(void)
+{
+    // Só as linhas visíveis são lidas; aqui apenas o total do nível
+    temp_centi_t lines[DISPLAY_LINES];
+    int count = history_lines(selected_channel, history_zoom, 0, lines, 0);
+
+    // Debug: mostra quantidade de registros armazenados no nível
+    widget_value_printf(&history_total, "Total: %d %s", count, history_zoom_labels[history_zoom]);
+
+    // O nível pode ter menos registros que a posição deixada em outro zoom
+    if (history_scroll_position > count - DISPLAY_LINES)
     {
-        if (temperature_history.scroll_position < (temperature_history.count - DISPLAY_LINES))
-        {
-            temperature_history.scroll_position++;
-        }
+        history_scroll_position = count > DISPLAY_LINES ? count - DISPLAY_LINES : 0;
     }
 
-    // Desenha as temperaturas visíveis
-    for (int i = 0; i < DISPLAY_LINES && i < temperature_history.count; i++)
+    // Temperaturas visíveis, do registro mais novo para o mais antigo; nos
+    // níveis de resumo a lista mostra a média de cada bloco
+    count = history_lines(selected_channel, history_zoom, history_scroll_position, lines, DISPLAY_LINES);
+    for (int i = 0; i < DISPLAY_LINES; i++)
     {
-        char temp_str[16];
-        int display_index = i + temperature_history.scroll_position;
+        char value_str[TEMP_STR_SIZE];
+        int display_index = i + history_scroll_position;
+
+        if (display_index < count)
+            widget_value_printf(&history_rows[i], "%3d: %s C", display_index + 1,
+                                temperature_format(value_str, lines[i], 1));
+        else
+            widget_value_set(&history_rows[i], "");
+    }
 
-        // Calcula o índice real no array circular
-        int actual_index = (temperature_history.newest_index - 1 - display_index + HISTORY_SIZE) % HISTORY_SIZE;
+    // Indicadores de rolagem
+    bool scrolls = count > DISPLAY_LINES;
+    widget_value_set(&history_up, scrolls && history_scroll_position > 0 ? "^" : "");
+    widget_value_set(&history_down, scrolls && history_scroll_position < count - DISPLAY_LINES ? "v" : "");
+}
 
-        snprintf(temp_str, sizeof(temp_str), "%2d: %.1f C",
-                 display_index + 1,
-                 map_value(temperature_history.temperatures[actual_index], 0, 4095, TEMP_MIN_SENSOR, TEMP_MAX_SENSOR));
+widget_t *const history_widgets[] = {
+    &history_total.base,
+    &history_rows[0].base,
+    &history_rows[1].base,
+    &history_rows[2].base,
+    &history_rows[3].base,
+    &history_up.base,
+    &history_down.base,
+};
+
+const widget_screen_t history_screen = {
+    .labels = history_labels,
+    .label_count = count_of(history_labels),
+    .draw_static = draw_title_rule,
+    .bind = bind_history_screen,
+    .widgets = history_widgets,
+    .widget_count = count_of(history_widgets),
+};
+
+// Joystick vertical no monitor: para cima aproxima o zoom do gráfico, para
+// baixo afasta. Um passo por movimento; é preciso voltar ao centro.
+// Verdadeiro se o zoom mudou.
+bool update_history_zoom(void)
+{
+    static bool centered = true;
+    uint16_t raw = hal_adc_read_aux(ADC_CHANNEL_SCROLL);
 
-        ssd1306_draw_string(ssd, temp_str, 5, 27 + (i * 10));
+    if (raw >= 1000 && raw <= 3000)
+    {
+        centered = true;
+        return false;
     }
+    if (!centered)
+        return false;
+    centered = false;
 
-    // Indicadores de rolagem
-    if (temperature_history.count > DISPLAY_LINES)
+    if (raw > 3000 && history_zoom > HISTORY_TIER_SECONDS)
     {
-        if (temperature_history.scroll_position > 0)
-        {
-            ssd1306_draw_string(ssd, "^", 120, 15);
-        }
-        if (temperature_history.scroll_position < (temperature_history.count - DISPLAY_LINES))
-        {
-            ssd1306_draw_string(ssd, "v", 120, 50);
-        }
+        history_zoom--;
+        return true;
+    }
+    if (raw < 1000 && history_zoom < HISTORY_TIER_COUNT - 1)
+    {
+        history_zoom++;
+        return true;
     }
+    return false;
 }
 
-// Função para converter valor do ADC em posição Y no gráfico
-int adc_to_y_position(uint16_t adc_value)
+// Faixa de temperatura do eixo Y do gráfico
+typedef struct
+{
+    temp_centi_t low;
+    temp_centi_t high;
+} GraphScale;
+
+// Ajusta o eixo Y ao trecho exibido: limites em graus inteiros e faixa
+// mínima de GRAPH_MIN_SPAN para o ruído não ocupar a altura toda
+GraphScale graph_autoscale(const history_record_t *span, int count)
 {
-    // Conversão linear: y = (52 * adc_value) / 4095
-    return (GRAPH_Y_MAX * adc_value) / ADC_MAX_VALUE;
+    GraphScale scale = {TEMP_CENTI(TEMP_MIN_SENSOR), TEMP_CENTI(TEMP_MAX_SENSOR)};
+    if (count == 0)
+        return scale;
+
+    int32_t low = span->min >= 0 ? span->min / 100 * 100 : -((-span->min + 99) / 100 * 100);
+    int32_t high = span->max >= 0 ? (span->max + 99) / 100 * 100 : -(-span->max / 100 * 100);
+    if (high - low < GRAPH_MIN_SPAN)
+    {
+        int32_t middle = (low + high) / 200 * 100;
+        low = middle - GRAPH_MIN_SPAN / 2;
+        high = middle + GRAPH_MIN_SPAN / 2;
+    }
+    scale.low = low < TEMP_CENTI_LOWEST ? TEMP_CENTI_LOWEST : low;
+    scale.high = high > TEMP_CENTI_HIGHEST ? TEMP_CENTI_HIGHEST : high;
+    return scale;
 }
 
-// Função atualizada para desenhar o gráfico
-void draw_graph_screen(ssd1306_t *ssd)
+// Função para converter uma temperatura em posição Y no gráfico
+int temp_to_y_position(temp_centi_t temp, const GraphScale *scale)
 {
-    ssd1306_fill(ssd, false);
+    // Conversão linear da faixa do eixo para 0-52
+    int32_t offset = (int32_t)temp - scale->low;
+    int32_t span = (int32_t)scale->high - scale->low;
+    if (offset < 0)
+        offset = 0;
+    if (offset > span)
+        offset = span;
+    return (GRAPH_Y_MAX * offset) / span;
+}
 
-    // Desenha eixos
+// Eixos do gráfico, fora do retângulo do traço (a linha da base fica com
+// o próprio traço, que a redesenha ao limpar)
+void draw_graph_static(ssd1306_t *ssd)
+{
     ssd1306_line(ssd, 10, 0, 10, GRAPH_Y_MAX, true);            // Eixo Y
     ssd1306_line(ssd, 10, GRAPH_Y_MAX, 127, GRAPH_Y_MAX, true); // Eixo X
+}
 
-    // Desenha marcações de escala no eixo Y
-    char value_str[8];
-    // Marca valor máximo (4095)
-    // snprintf(value_str, sizeof(value_str), "4095");
-    // ssd1306_draw_string(ssd, value_str, 0, 0);
-
-    // Marca valor médio (2047)
-    // snprintf(value_str, sizeof(value_str), "2047");
-    // ssd1306_draw_string(ssd, value_str, 0, GRAPH_Y_MID - 4);
-
-    // Marca valor mínimo (0)
-    // snprintf(value_str, sizeof(value_str), "0");
-    // ssd1306_draw_string(ssd, value_str, 0, GRAPH_Y_MAX - 8);
-
-    // Desenha linha de referência no ponto médio
-    // ssd1306_line(ssd, 10, GRAPH_Y_MID, 15, GRAPH_Y_MID, true);
+// Ponto 0 (registro mais novo) na coluna 127, como antes
+widget_sparkline_t graph_trace = {
+    .base = {WIDTH - GRAPH_POINTS, 0, GRAPH_POINTS, GRAPH_Y_MAX + 1, true, widget_sparkline_render},
+    .baseline = true,
+};
+widget_value_t graph_temp = WIDGET_VALUE(20, 0, 6);
+widget_value_t graph_zoom = WIDGET_VALUE(100, 0, 3);
+widget_value_t graph_span = WIDGET_VALUE(12, 55, 14);
 
-    // Plota os pontos usando valores diretos do ADC
-    for (int i = 0; i < temperature_history.count - 1 && i < 116; i++)
+void bind_graph_screen(void)
+{
+    // Cópia consistente do nível exibido, do registro mais novo para o mais
+    // antigo (fora da pilha de 2 KB do núcleo 0)
+    static history_record_t history[HISTORY_SIZE];
+    history_record_t span;
+    int count = history_snapshot(selected_channel, history_zoom, history, HISTORY_SIZE,
+                                 &span, GRAPH_POINTS);
+    GraphScale scale = graph_autoscale(&span, count);
+
+    // Média de cada registro em linhas da tela; nos níveis de resumo uma
+    // barra vertical mostra a faixa entre o mínimo e o máximo do bloco
+    uint8_t mean[GRAPH_POINTS], low[GRAPH_POINTS], high[GRAPH_POINTS];
+    int points = count < GRAPH_POINTS ? count : GRAPH_POINTS;
+    for (int i = 0; i < points; i++)
     {
-        int idx = (temperature_history.newest_index - 1 - i + HISTORY_SIZE) % HISTORY_SIZE;
-        int next_idx = (temperature_history.newest_index - 2 - i + HISTORY_SIZE) % HISTORY_SIZE;
-
-        uint16_t adc_value = temperature_history.temperatures[idx];
-        uint16_t next_adc_value = temperature_history.temperatures[next_idx];
-
-        // Converte valores ADC para posições Y
-        int y1 = GRAPH_Y_MAX - adc_to_y_position(adc_value);
-        int y2 = GRAPH_Y_MAX - adc_to_y_position(next_adc_value);
-
-        ssd1306_line(ssd, 127 - i, y1, 126 - i, y2, true);
+        mean[i] = GRAPH_Y_MAX - temp_to_y_position(history[i].mean, &scale);
+        low[i] = GRAPH_Y_MAX - temp_to_y_position(history[i].min, &scale);
+        high[i] = GRAPH_Y_MAX - temp_to_y_position(history[i].max, &scale);
+    }
+    bool range = history_zoom != HISTORY_TIER_SECONDS;
+    widget_sparkline_set(&graph_trace, mean, range ? low : NULL, range ? high : NULL, points);
+
+    // Temperatura atual e nível de zoom do gráfico
+    SystemStatus status;
+    status_snapshot(&status);
+    temperature_format(TEMP_REAL, status.latest_temp[selected_channel], 2);
+    widget_value_set(&graph_temp, TEMP_REAL);
+    widget_value_set(&graph_zoom, history_zoom_labels[history_zoom]);
+
+    // Resumo do trecho exibido: mínimo/média/máximo (o eixo vai dos graus
+    // inteiros abaixo do mínimo aos acima do máximo)
+    if (count > 0)
+    {
+        char min_str[TEMP_STR_SIZE], mean_str[TEMP_STR_SIZE], max_str[TEMP_STR_SIZE];
+        widget_value_printf(&graph_span, "%s/%s/%s",
+                            temperature_format(min_str, span.min, 1),
+                            temperature_format(mean_str, span.mean, 1),
+                            temperature_format(max_str, span.max, 1));
+    }
+    else
+    {
+        widget_value_set(&graph_span, "");
     }
-
-    // Mostra valor ADC atual
-    uint16_t current_adc = temperature_history.temperatures[(temperature_history.newest_index - 1 + HISTORY_SIZE) % HISTORY_SIZE];
-    // snprintf(value_str, sizeof(value_str), "ADC:%d", current_adc);
-
-    // conversao para valores de temperatura REAL
-    ssd1306_draw_string(ssd, value_str, 30, 0);
-    // Buffer para armazenar a string
-    sprintf(TEMP_REAL, "%.2f", map_value(current_adc, 0, 4095, TEMP_MIN_SENSOR, TEMP_MAX_SENSOR)); // Converte o inteiro em string
-
-    ssd1306_draw_string(ssd, TEMP_REAL, 20, 0); // Desenha uma string
 }
 
-// Função para verificar e atualizar o estado do alerta
-void update_alert_status(float current_temp)
+// Os textos vêm depois do traço: ficam por cima quando ele é redesenhado
+widget_t *const graph_widgets[] = {
+    &graph_trace.base,
+    &graph_temp.base,
+    &graph_zoom.base,
+    &graph_span.base,
+};
+
+const widget_screen_t graph_screen = {
+    .draw_static = draw_graph_static,
+    .bind = bind_graph_screen,
+    .widgets = graph_widgets,
+    .widget_count = count_of(graph_widgets),
+};
+
+// Função para verificar e atualizar o estado do alerta de um canal
+// (núcleo 1, dentro da seção de escrita de status_lock)
+void update_alert_status(uint8_t channel, temp_centi_t current_temp, const AlertConfig *config)
 {
-    if (current_temp > alert_config.temp_urgent_max)
+    if (current_temp > config->temp_urgent_max)
     {
-        alert_config.current_alert = ALERT_URGENT;
+        system_status.channel_alert[channel] = ALERT_URGENT;
     }
-    else if (current_temp > alert_config.temp_normal_max)
+    else if (current_temp > config->temp_normal_max)
     {
-        alert_config.current_alert = ALERT_ATTENTION;
+        system_status.channel_alert[channel] = ALERT_ATTENTION;
     }
     else
     {
-        alert_config.current_alert = ALERT_NORMAL;
+        system_status.channel_alert[channel] = ALERT_NORMAL;
     }
 }
 
-// Função para desenhar a tela de alertas
-void draw_alerts_screen(ssd1306_t *ssd)
-{
-    ssd1306_fill(ssd, false);
+// Tela de alertas
+const widget_label_t alerts_labels[] = {{10, 0, "Status System"}};
 
-    // Título
-    ssd1306_draw_string(ssd, "Status System", 10, 0);
-    ssd1306_line(ssd, 0, 10, 128, 10, true);
+widget_value_t alerts_temp = WIDGET_VALUE(5, 15, 15);
+widget_box_t alerts_frame = WIDGET_BOX(20, 40, 100, 20); // Borda de atenção e urgência
+widget_value_t alerts_state = WIDGET_VALUE(45, 45, 8);
+
+void bind_alerts_screen(void)
+{
+    SystemStatus status;
+    status_snapshot(&status);
 
     // Temperatura atual
-    char temp_str[32];
-    float current_temp = map_value(adc_read(), 0, 4095, TEMP_MIN_SENSOR, TEMP_MAX_SENSOR);
-    snprintf(temp_str, sizeof(temp_str), "Temp: %.1f C", current_temp);
-    ssd1306_draw_string(ssd, temp_str, 5, 15);
+    char value_str[TEMP_STR_SIZE];
+    widget_value_printf(&alerts_temp, "Temp: %s C",
+                        temperature_format(value_str, status.latest_temp[selected_channel], 1));
 
     // Status do alerta
     const char *alert_str;
-    switch (alert_config.current_alert)
+    switch (status.current_alert)
     {
     case ALERT_URGENT:
         alert_str = "URGENTE!";
-        // Desenha uma borda piscante para alertas urgentes
-
-        ssd1306_rect(ssd, 40, 20, 100, 20, true, false); // último parâmetro: fill = false
-
         break;
     case ALERT_ATTENTION:
         alert_str = "Atencao!";
-        // Desenha uma borda simples para atenção
-        ssd1306_rect(ssd, 40, 20, 100, 20, true, false); // último parâmetro: fill = false
         break;
     default:
         alert_str = "Normal";
-        pwm_set_duty(LED_R, 0);   // LED vermelho com eixo X
-        pwm_set_duty(LED_G, 500); // LED verde com eixo Y
-        pwm_set_duty(LED_B, 0);   // LED azul com eixo Z
         break;
     }
-
-    ssd1306_draw_string(ssd, alert_str, 45, 45);
+    widget_box_set(&alerts_frame, status.current_alert != ALERT_NORMAL);
+    widget_value_set(&alerts_state, alert_str);
 }
 
-// Atualizar a função de configuração
-void draw_config_screen(ssd1306_t *ssd)
+widget_t *const alerts_widgets[] = {
+    &alerts_temp.base,
+    &alerts_frame.base,
+    &alerts_state.base,
+};
+
+const widget_screen_t alerts_screen = {
+    .labels = alerts_labels,
+    .label_count = count_of(alerts_labels),
+    .draw_static = draw_title_rule,
+    .bind = bind_alerts_screen,
+    .widgets = alerts_widgets,
+    .widget_count = count_of(alerts_widgets),
+};
+
+// Tela de configuração
+const widget_label_t config_labels[] = {{20, 0, "Configuracao"}};
+
+widget_value_t config_rows[3] = {
+    WIDGET_VALUE(5, 20, 15),
+    WIDGET_VALUE(5, 35, 15),
+    WIDGET_VALUE(5, 50, 15),
+};
+
+void bind_config_screen(void)
 {
     static int selected_option = 0;
     static bool editing = false;
 
-    ssd1306_fill(ssd, false);
-    ssd1306_draw_string(ssd, "Configuracao", 20, 0);
-    ssd1306_line(ssd, 0, 10, 128, 10, true);
-
-    char temp_str[32];
+    char value_str[TEMP_STR_SIZE];
+    AlertConfig config;
+    alert_config_snapshot(&config);
 
     // Opções de configuração
-    snprintf(temp_str, sizeof(temp_str), "%sNormal: %.1f",
-             (selected_option == 0 && editing) ? ">" : " ",
-             alert_config.temp_normal_max);
-    ssd1306_draw_string(ssd, temp_str, 5, 20);
-
-    snprintf(temp_str, sizeof(temp_str), "%sAtencao: %.1f",
-             (selected_option == 1 && editing) ? ">" : " ",
-             alert_config.temp_attention_max);
-    ssd1306_draw_string(ssd, temp_str, 5, 35);
+    widget_value_printf(&config_rows[0], "%sNormal: %s",
+                        (selected_option == 0 && editing) ? ">" : " ",
+                        temperature_format(value_str, config.temp_normal_max, 1));
+    widget_value_printf(&config_rows[1], "%sAtencao: %s",
+                        (selected_option == 1 && editing) ? ">" : " ",
+                        temperature_format(value_str, config.temp_attention_max, 1));
+    widget_value_printf(&config_rows[2], "%sUrgente: %s",
+                        (selected_option == 2 && editing) ? ">" : " ",
+                        temperature_format(value_str, config.temp_urgent_max, 1));
+}
 
-    snprintf(temp_str, sizeof(temp_str), "%sUrgente: %.1f",
-             (selected_option == 2 && editing) ? ">" : " ",
-             alert_config.temp_urgent_max);
-    ssd1306_draw_string(ssd, temp_str, 5, 50);
+widget_t *const config_widgets[] = {
+    &config_rows[0].base,
+    &config_rows[1].base,
+    &config_rows[2].base,
+};
+
+const widget_screen_t config_screen = {
+    .labels = config_labels,
+    .label_count = count_of(config_labels),
+    .draw_static = draw_title_rule,
+    .bind = bind_config_screen,
+    .widgets = config_widgets,
+    .widget_count = count_of(config_widgets),
+};
+
+// Fim de uma varredura de todos os canais (contexto da IRQ do DMA, núcleo 1)
+void temperature_scan_done(const uint16_t *adc_q4, uint32_t scans)
+{
+    PROBE_BEGIN(isr_start);
+    PROBE_INTERVAL(&probes[PROBE_SCAN_JITTER], TEMP_READ_INTERVAL_MS * 1000);
+    temp_centi_t temps[SENSOR_CHANNEL_COUNT];
+    SampleRecord record = {.sequence = scans};
+    AlertType worst = ALERT_NORMAL;
+    AlertConfig config;
+    alert_config_snapshot(&config); // Os mesmos limites para todos os canais
+
+    seqlock_write_begin(&status_lock);
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        // Leitura já filtrada pela sobreamostragem; mantém a fração abaixo de 1 LSB
+        record.adc_q4[ch] = adc_q4[ch];
+        temp_centi_t current_temp = temperature_from_adc_q4(adc_q4[ch]);
+        temps[ch] = current_temp;
+        system_status.latest_adc_q4[ch] = adc_q4[ch];
+        system_status.latest_temp[ch] = current_temp;
+
+        // Atualiza o estado do alerta
+        update_alert_status(ch, current_temp, &config);
+        if (system_status.channel_alert[ch] > worst)
+            worst = system_status.channel_alert[ch];
+    }
+    system_status.current_alert = worst;
+    system_status.scans = scans;
+    seqlock_write_end(&status_lock);
 
-    // Instruções
-    if (editing)
+    // Atualiza média, desvio e extremos das janelas em O(1) por canal
+    seqlock_write_begin(&stats_lock);
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
     {
-        //ssd1306_draw_string(ssd, "A:+/B:-", 90, 55);
+        stream_stats_add(&channel_stats[ch], temps[ch]);
     }
+    seqlock_write_end(&stats_lock);
+
+    // Atualiza o LED RGB baseado no pior alerta entre os canais
+    update_led_status(worst);
+
+    // Armazena as temperaturas da varredura
+    add_temperature_to_history(temps);
+
+    // Entrega a varredura ao núcleo 0; se ele estiver atrasado o registro é
+    // descartado (contado em sample_ring.dropped), pois as telas leem o estado
+    spsc_ring_push(&sample_ring, &record);
+    events_post(EVENT_SAMPLE);
+
+    PROBE_END(&probes[PROBE_SCAN_ISR], isr_start);
+    PROBE_TRACE(TRACE_SCAN, scans);
+}
+
+// Tela de estatísticas
+widget_value_t stats_title = WIDGET_VALUE(SENSOR_CHANNEL_COUNT > 1 ? 10 : 20, 0, 14);
+widget_value_t stats_rows[5] = {
+    WIDGET_VALUE(5, 15, 15),
+    WIDGET_VALUE(5, 25, 15),
+    WIDGET_VALUE(5, 35, 15),
+    WIDGET_VALUE(5, 45, 15),
+    WIDGET_VALUE(5, 55, 15),
+};
+
+void bind_stats_screen(void)
+{
+    // Título
+    if (SENSOR_CHANNEL_COUNT > 1)
+        widget_value_printf(&stats_title, "Stats canal %d", selected_channel + 1);
     else
+        widget_value_set(&stats_title, "Estatisticas");
+
+    SystemStatus status;
+    status_snapshot(&status);
+
+    // Temperatura atual
+    char value_str[TEMP_STR_SIZE];
+    char second_str[TEMP_STR_SIZE];
+    widget_value_printf(&stats_rows[0], "Atual: %s C",
+                        temperature_format(value_str, status.latest_temp[selected_channel], 1));
+
+    // Janela selecionada pelo botão A
+    widget_value_printf(&stats_rows[1], "Janela: %s", stats_window_labels[stats_window]);
+
+    stream_stats_summary_t summary;
+    if (!stats_snapshot(selected_channel, stats_window, &summary))
     {
-       // ssd1306_draw_string(ssd, "A:Sel/B:Edit", 70, 55);
+        widget_value_set(&stats_rows[2], "Sem amostras");
+        widget_value_set(&stats_rows[3], "");
+        widget_value_set(&stats_rows[4], "");
+        return;
     }
+
+    // Média da janela
+    widget_value_printf(&stats_rows[2], "Media: %s C",
+                        temperature_format(value_str, summary.mean, 1));
+
+    // Temperaturas mínima e máxima da janela
+    widget_value_printf(&stats_rows[3], "%s a %s C",
+                        temperature_format(value_str, summary.min, 1),
+                        temperature_format(second_str, summary.max, 1));
+
+    // Desvio padrão desde o início ou quantidade de amostras da janela
+    if (stats_window == STATS_TOTAL)
+        widget_value_printf(&stats_rows[4], "Desvio: %s C",
+                            temperature_format(value_str, summary.stddev, 2));
+    else
+        widget_value_printf(&stats_rows[4], "Amostras: %lu", (unsigned long)summary.count);
 }
 
-// Atualizar o callback do timer
-bool temperature_alarm_callback(struct repeating_timer *t)
+widget_t *const stats_widgets[] = {
+    &stats_title.base,
+    &stats_rows[0].base,
+    &stats_rows[1].base,
+    &stats_rows[2].base,
+    &stats_rows[3].base,
+    &stats_rows[4].base,
+};
+
+const widget_screen_t stats_screen = {
+    .draw_static = draw_title_rule,
+    .bind = bind_stats_screen,
+    .widgets = stats_widgets,
+    .widget_count = count_of(stats_widgets),
+};
+
+// Tela de diagnóstico: médias e piores casos da instrumentação desde o
+// início (ou desde o último "diag reset"/botão A)
+const widget_label_t diag_labels[] = {{0, 0, "Diag  media/pior"}};
+
+widget_value_t diag_rows[5] = {
+    WIDGET_VALUE(0, 14, 16),
+    WIDGET_VALUE(0, 24, 16),
+    WIDGET_VALUE(0, 34, 16),
+    WIDGET_VALUE(0, 44, 16),
+    WIDGET_VALUE(0, 54, 16),
+};
+
+uint32_t probe_to_us(ProbeId id, uint32_t value)
 {
-    adc_select_input(ADC_CHANNEL_TEMP);
-    uint16_t adc_value = adc_read();
-    float current_temp = map_value(adc_value, 0, 4095, TEMP_MIN_SENSOR, TEMP_MAX_SENSOR);
+    return probe_info[id].cycles ? (uint32_t)((uint64_t)value * 1000000 / hal_cycles_hz()) : value;
+}
 
-    // Atualiza o estado do alerta
-    update_alert_status(current_temp);
+// Duração em até 5 caracteres para a tela: "850us", "8.5ms", "125ms", "1.2s"
+char *format_duration(char *out, size_t size, uint32_t us)
+{
+    if (us < 1000)
+        snprintf(out, size, "%luus", (unsigned long)us);
+    else if (us < 10000)
+        snprintf(out, size, "%lu.%lums", (unsigned long)(us / 1000), (unsigned long)(us % 1000 / 100));
+    else if (us < 1000000)
+        snprintf(out, size, "%lums", (unsigned long)(us / 1000));
+    else if (us < 10000000)
+        snprintf(out, size, "%lu.%lus", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000 / 100000));
+    else
+        snprintf(out, size, "%lus", (unsigned long)(us / 1000000));
+    return out;
+}
 
-    // Atualiza o LED RGB baseado no estado atual do alerta
-    update_led_status(alert_config.current_alert);
+void diag_row(widget_value_t *row, const char *label, ProbeId id, uint32_t mean, uint32_t max)
+{
+    char mean_str[12], max_str[12];
+    widget_value_printf(row, "%-4s %s/%s", label,
+                        format_duration(mean_str, sizeof(mean_str), probe_to_us(id, mean)),
+                        format_duration(max_str, sizeof(max_str), probe_to_us(id, max)));
+}
 
-    // Atualiza máximos e mínimos
-    if (current_temp > temp_scale.current_max)
+void bind_diag_screen(void)
+{
+    if (!PROBE_ENABLED)
     {
-        temp_scale.current_max = current_temp;
+        widget_value_set(&diag_rows[0], "Desligado");
+        return;
     }
-    if (current_temp < temp_scale.current_min)
+
+    diag_row(&diag_rows[0], "ISR", PROBE_SCAN_ISR, probe_mean(&probes[PROBE_SCAN_ISR]),
+             probes[PROBE_SCAN_ISR].max);
+    diag_row(&diag_rows[1], "Jit", PROBE_SCAN_JITTER, probe_mean(&probes[PROBE_SCAN_JITTER]),
+             probes[PROBE_SCAN_JITTER].max);
+
+    // Desenho: todas as telas juntas
+    uint64_t sum = 0;
+    uint32_t count = 0, max = 0;
+    for (uint8_t state = 0; state < STATE_COUNT; state++)
     {
-        temp_scale.current_min = current_temp;
+        const probe_stat_t *render = &probes[PROBE_RENDER + state];
+        sum += render->sum;
+        count += render->count;
+        if (render->max > max)
+            max = render->max;
     }
+    diag_row(&diag_rows[2], "Tela", PROBE_RENDER, count ? (uint32_t)(sum / count) : 0, max);
+    diag_row(&diag_rows[3], "I2C", PROBE_FLUSH_BUS, probe_mean(&probes[PROBE_FLUSH_BUS]),
+             probes[PROBE_FLUSH_BUS].max);
+
+    // Quadros por segundo pelo período médio, em décimos
+    uint32_t frame_us = probe_mean(&probes[PROBE_FRAME]);
+    uint32_t fps10 = frame_us ? 10000000u / frame_us : 0;
+    widget_value_printf(&diag_rows[4], "FPS  %lu.%lu", (unsigned long)(fps10 / 10), (unsigned long)(fps10 % 10));
+}
 
-    // Armazena o valor bruto do ADC
-    temperature_history.temperatures[temperature_history.newest_index] = adc_value;
-    temperature_history.newest_index = (temperature_history.newest_index + 1) % HISTORY_SIZE;
-    if (temperature_history.count < HISTORY_SIZE)
+widget_t *const diag_widgets[] = {
+    &diag_rows[0].base,
+    &diag_rows[1].base,
+    &diag_rows[2].base,
+    &diag_rows[3].base,
+    &diag_rows[4].base,
+};
+
+const widget_screen_t diag_screen = {
+    .labels = diag_labels,
+    .label_count = count_of(diag_labels),
+    .draw_static = draw_title_rule,
+    .bind = bind_diag_screen,
+    .widgets = diag_widgets,
+    .widget_count = count_of(diag_widgets),
+};
+
+void probes_reset(void)
+{
+    for (uint8_t id = 0; id < PROBE_COUNT; id++)
     {
-        temperature_history.count++;
+        probe_reset(&probes[id]);
     }
+}
 
-    new_temperature_available = true;
-    return true;
+const widget_screen_t *const screens[] = {
+    [STATE_SPLASH] = &splash_screen,
+    [STATE_MENU] = &menu_screen,
+    [STATE_MONITOR] = &graph_screen,
+    [STATE_HISTORY] = &history_screen,
+    [STATE_CONFIG] = &config_screen,
+    [STATE_STATS] = &stats_screen,
+    [STATE_ALERTS] = &alerts_screen,
+    [STATE_DIAG] = &diag_screen,
+};
+
+// Desenha a tela do estado atual no framebuffer: só os widgets que mudaram
+void draw_current_screen(ssd1306_t *ssd)
+{
+    PROBE_BEGIN(render_start);
+    widget_screen_render(ssd, screens[current_state]);
+    PROBE_END(&probes[PROBE_RENDER + current_state], render_start);
+    PROBE_TRACE(TRACE_RENDER, current_state);
 }
 
-// Adicionar função para desenhar a tela de estatísticas
-void draw_stats_screen(ssd1306_t *ssd)
+// Telas que mostram as leituras e precisam de um quadro novo a cada varredura
+bool screen_shows_samples(SystemState state)
 {
-    ssd1306_fill(ssd, false);
+    return state == STATE_MONITOR || state == STATE_HISTORY || state == STATE_STATS ||
+           state == STATE_ALERTS || state == STATE_DIAG;
+}
 
-    // Título
-    ssd1306_draw_string(ssd, "Estatisticas", 20, 0);
-    ssd1306_line(ssd, 0, 10, 128, 10, true);
+// Telas que mostram os limites de alerta
+bool screen_shows_config(SystemState state)
+{
+    return state == STATE_CONFIG || state == STATE_ALERTS;
+}
 
-    // Temperatura atual
-    char temp_str[32];
-    float current_temp = map_value(adc_read(), 0, 4095, TEMP_MIN_SENSOR, TEMP_MAX_SENSOR);
-    snprintf(temp_str, sizeof(temp_str), "Atual: %.1f C", current_temp);
-    ssd1306_draw_string(ssd, temp_str, 5, 20);
+bool screen_uses_joystick(SystemState state)
+{
+    return state == STATE_MONITOR || state == STATE_HISTORY;
+}
 
-    // Temperatura máxima
-    snprintf(temp_str, sizeof(temp_str), "Max: %.1f C", temp_scale.current_max);
-    ssd1306_draw_string(ssd, temp_str, 5, 35);
+// Estado inicial da aplicação: histórico, estatísticas (máximos e mínimos
+// vazios) e as filas entre os núcleos
+void monitor_init(void)
+{
+    temperature_init();
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        history_init(&channel_history[ch]);
+        stream_stats_init(&channel_stats[ch]);
+    }
+    spsc_ring_init(&sample_ring, sample_ring_buffer, sizeof(SampleRecord), SAMPLE_RING_SIZE);
+    spsc_ring_init(&archive_ring, archive_ring_buffer, sizeof(ArchiveRecord), ARCHIVE_RING_SIZE);
 
-    // Temperatura mínima
-    snprintf(temp_str, sizeof(temp_str), "Min: %.1f C", temp_scale.current_min);
-    ssd1306_draw_string(ssd, temp_str, 5, 50);
+    // Inicializa o tempo inicial da tela splash
+    splash_start_time = hal_time_ms();
 }
 
-int main()
+// Navegação pelos botões A e B. Verdadeiro se a tela mudou.
+bool handle_buttons(void)
 {
-    // Inicialização do sistema
-    stdio_init_all();
+    bool changed = false;
+
+    // Tratamento da interrupção do botão A
+    if (button_a_pressed)
+    {
+        if (current_state == STATE_MENU)
+        {
+            selected_menu_item = (selected_menu_item + 1) % MENU_COUNT;
+        }
+        else if (current_state == STATE_MONITOR && SENSOR_CHANNEL_COUNT > 1)
+        {
+            // Com vários sensores o botão A alterna o canal exibido
+            selected_channel = (selected_channel + 1) % SENSOR_CHANNEL_COUNT;
+        }
+        else if (current_state == STATE_MONITOR)
+        {
+            current_state = STATE_MENU;
+        }
+        else if (current_state == STATE_STATS)
+        {
+            // Alterna entre as janelas de 1 min, 15 min, 1 h e o total
+            stats_window = (stats_window + 1) % (STATS_WINDOW_COUNT + 1);
+        }
+        else if (current_state == STATE_DIAG)
+        {
+            probes_reset();
+        }
+        button_a_pressed = false;
+        changed = true;
+    }
+
+    // Tratamento da interrupção do botão B
+    if (button_b_pressed)
+    {
+        if (current_state == STATE_MENU)
+        {
+            switch (selected_menu_item)
+            {
+            case MENU_MONITOR:
+                current_state = STATE_MONITOR;
+                break;
+            case MENU_HISTORY:
+                current_state = STATE_HISTORY;
+                break;
+            case MENU_CONFIG:
+                current_state = STATE_CONFIG;
+                break;
+            case MENU_STATS:
+                current_state = STATE_STATS;
+                break;
+            case MENU_ALERTS:
+                current_state = STATE_ALERTS;
+                break;
+            case MENU_DIAG:
+                current_state = STATE_DIAG;
+                break;
+            }
+        }
+        else if (current_state != STATE_SPLASH)
+        {
+            current_state = STATE_MENU;
+        }
+        button_b_pressed = false;
+        changed = true;
+    }
+    return changed;
+}
 
-    // Inicialização do ADC
-    adc_init();
-    adc_gpio_init(TEMP_SENSOR_PIN);
+// Fim da tela inicial. Verdadeiro se a tela mudou.
+bool update_splash(void)
+{
+    if (current_state == STATE_SPLASH && hal_time_ms() - splash_start_time > SPLASH_DURATION)
+    {
+        current_state = STATE_MENU;
+        return true;
+    }
+    return false;
+}
 
-    // Inicialização do I2C
-    i2c_init(I2C_PORT, 400 * 1000);
-    gpio_set_function(I2C_SDA, GPIO_FUNC_I2C);
-    gpio_set_function(I2C_SCL, GPIO_FUNC_I2C);
-    gpio_pull_up(I2C_SDA);
-    gpio_pull_up(I2C_SCL);
+#ifndef MONITOR_APP_ONLY
 
-    // Inicialização do display OLED
-    ssd1306_t ssd;
-    ssd1306_init(&ssd, 128, 64, false, DISPLAY_ADDR, I2C_PORT);
-    ssd1306_config(&ssd);
+// Capacidade do arquivo na flash para um registro por minuto
+void print_archive_report(void)
+{
+    flash_log_info_t info;
+    flash_log_info(ARCHIVE_RECORDS_PER_DAY, &info);
+    if (info.records_per_page == 0)
+    {
+        printf("Arquivo na flash indisponivel\n");
+        return;
+    }
+    printf("Arquivo: %lu minutos gravados, %u por pagina (%u sem compressao), %lu bytes/dia\n",
+           (unsigned long)flash_log_records(), info.records_per_page, info.records_per_page_raw,
+           (unsigned long)info.bytes_per_day);
+    printf("Arquivo: retencao %lu dias, vida util %lu anos\n",
+           (unsigned long)info.retention_days, (unsigned long)info.lifetime_years);
+}
 
-    // Inicializa o tempo inicial da tela splash
-    splash_start_time = to_ms_since_boot(get_absolute_time());
-
-    // Adicione a inicialização do botão A após as outras inicializações
-    gpio_init(BUTTON_A_PIN);
-    gpio_set_dir(BUTTON_A_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_A_PIN);
-
-    // Adicione a inicialização do botão B junto com a do botão A
-    gpio_init(BUTTON_B_PIN);
-    gpio_set_dir(BUTTON_B_PIN, GPIO_IN);
-    gpio_pull_up(BUTTON_B_PIN);
-
-    // Configura os LEDs para modo PWM
-    gpio_set_function(LED_R, GPIO_FUNC_PWM);
-    gpio_set_function(LED_G, GPIO_FUNC_PWM);
-    gpio_set_function(LED_B, GPIO_FUNC_PWM);
-
-    // Configuração do PWM para os LEDs
-    uint slice_num_r = pwm_gpio_to_slice_num(LED_R);
-    uint slice_num_g = pwm_gpio_to_slice_num(LED_G);
-    uint slice_num_b = pwm_gpio_to_slice_num(LED_B);
-
-    // Configura PWM 50Hz para todos os LEDs
-    pwm_set_clkdiv(slice_num_r, 1250);
-    pwm_set_clkdiv(slice_num_g, 1250);
-    pwm_set_clkdiv(slice_num_b, 1250);
-
-    pwm_set_wrap(slice_num_r, 2000);
-    pwm_set_wrap(slice_num_g, 2000);
-    pwm_set_wrap(slice_num_b, 2000);
-
-    // Habilita o PWM para todos os LEDs
-    pwm_set_enabled(slice_num_r, true);
-    pwm_set_enabled(slice_num_g, true);
-    pwm_set_enabled(slice_num_b, true);
-
-    // Configuração das interrupções para ambos os botões
-    gpio_set_irq_enabled_with_callback(BUTTON_A_PIN,
-                                       GPIO_IRQ_EDGE_FALL,
-                                       true,
-                                       &gpio_callback);
-
-    gpio_set_irq_enabled_with_callback(BUTTON_B_PIN,
-                                       GPIO_IRQ_EDGE_FALL,
-                                       true,
-                                       &gpio_callback);
-
-    // Configura o alarme para leitura de temperatura
-    struct repeating_timer timer;
-    add_repeating_timer_ms(TEMP_READ_INTERVAL_MS, temperature_alarm_callback, NULL, &timer);
-
-    // Inicializa os valores de máximo e mínimo
-    temp_scale.current_max = -100.0f; // Começa com um valor baixo
-    temp_scale.current_min = 200.0f;  // Começa com um valor alto
-
-    // Loop principal
-    while (true)
+// Download em curso pelo protocolo binário (apenas núcleo 0)
+typedef struct
+{
+    uint8_t kind; // 0 (nenhum), STREAM_MSG_HISTORY ou STREAM_MSG_ARCHIVE
+    uint8_t channel;
+    uint8_t tier;
+    uint32_t next_index; // Histórico: índices absolutos em [next_index, end_index)
+    uint32_t end_index;
+    uint32_t frames;
+    flash_log_cursor_t cursor;
+} StreamDownload;
+
+StreamDownload stream_download;
+AlertType stream_alerts[SENSOR_CHANNEL_COUNT]; // Último alerta enviado por canal
+
+// Espelho do display no host (STREAM_CMD_MIRROR). Prioridade mais baixa do
+// protocolo: um quadro só sai com a fila da USB vazia e sem download, no
+// máximo a cada MIRROR_INTERVAL_MS; o que não coube vai no quadro seguinte.
+#define MIRROR_INTERVAL_MS 100
+
+display_mirror_t stream_mirror;
+bool stream_mirror_on;
+bool stream_mirror_pending; // Tela redesenhada ainda não espelhada
+absolute_time_t stream_mirror_next;
+
+// Liga o modo binário e anuncia a configuração
+void stream_begin(void)
+{
+    usb_stream_start();
+    stream_download.kind = 0;
+    stream_mirror_on = false;
+
+    SystemStatus status;
+    status_snapshot(&status);
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        stream_alerts[ch] = status.channel_alert[ch];
+    }
+
+    stream_msg_info_t info = {
+        .version = STREAM_PROTOCOL_VERSION,
+        .channels = SENSOR_CHANNEL_COUNT,
+        .scan_interval_ms = TEMP_READ_INTERVAL_MS,
+        .history_tiers = HISTORY_TIER_COUNT,
+        .archive_fields = ARCHIVE_FIELDS};
+    usb_stream_send(STREAM_MSG_INFO, &info, sizeof(info));
+}
+
+// Uma varredura, com a leitura e a temperatura de cada canal
+void stream_send_sample(const SampleRecord *record)
+{
+    struct __attribute__((packed))
+    {
+        stream_msg_sample_t header;
+        stream_msg_channel_t channels[SENSOR_CHANNEL_COUNT];
+    } sample = {.header.sequence = record->sequence};
+
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        sample.channels[ch].adc_q4 = record->adc_q4[ch];
+        sample.channels[ch].temp = temperature_from_adc_q4(record->adc_q4[ch]);
+    }
+    usb_stream_send(STREAM_MSG_SAMPLE, &sample, sizeof(sample));
+}
+
+// Transições de alerta desde o último envio
+void stream_send_alerts(void)
+{
+    SystemStatus status;
+    status_snapshot(&status);
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
     {
-        // Tratamento da interrupção do botão A
-        if (button_a_pressed)
+        if (status.channel_alert[ch] == stream_alerts[ch])
+            continue;
+        stream_msg_alert_t alert = {
+            .sequence = status.scans,
+            .channel = ch,
+            .previous = stream_alerts[ch],
+            .current = status.channel_alert[ch],
+            .temp = status.latest_temp[ch]};
+        if (usb_stream_send(STREAM_MSG_ALERT, &alert, sizeof(alert)))
+            stream_alerts[ch] = status.channel_alert[ch];
+    }
+}
+
+// Estatísticas de todas as janelas e contadores, a cada minuto
+void stream_send_minute_report(void)
+{
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        for (uint8_t window = 0; window <= STATS_TOTAL; window++)
+        {
+            stream_stats_summary_t summary;
+            if (!stats_snapshot(ch, window, &summary))
+                continue;
+            stream_msg_stats_t stats = {
+                .channel = ch,
+                .window = window,
+                .min = summary.min,
+                .max = summary.max,
+                .mean = summary.mean,
+                .stddev = summary.stddev,
+                .count = summary.count};
+            usb_stream_send(STREAM_MSG_STATS, &stats, sizeof(stats));
+        }
+    }
+
+    SystemStatus status;
+    status_snapshot(&status);
+    stream_msg_status_t report = {
+        .scans = status.scans,
+        .ring_dropped = sample_ring.dropped,
+        .stream_dropped = usb_stream_dropped(),
+        .rx_errors = usb_stream_rx_errors()};
+    usb_stream_send(STREAM_MSG_STATUS, &report, sizeof(report));
+}
+
+// Gera os quadros do download enquanto houver espaço na fila, sem esperar
+void stream_download_pump(void)
+{
+    while (stream_download.kind && usb_stream_fits(FRAME_MAX_PAYLOAD))
+    {
+        if (stream_download.kind == STREAM_MSG_HISTORY)
         {
-            if (current_state == STATE_MENU)
+            struct __attribute__((packed))
+            {
+                stream_msg_history_t header;
+                history_record_t records[STREAM_HISTORY_CHUNK];
+            } chunk;
+            const history_channel_t *history = &channel_history[stream_download.channel];
+            uint8_t tier = stream_download.tier;
+            uint32_t first = stream_download.next_index;
+            uint32_t seq;
+            uint32_t count;
+            do
             {
-                selected_menu_item = (selected_menu_item + 1) % MENU_COUNT;
+                // Idade de cada índice no momento da leitura; registros que já
+                // saíram do anel encerram o download
+                seq = seqlock_read_begin(&history_lock);
+                uint32_t total = history_written(history, tier);
+                uint32_t oldest = total - history_count(history, tier);
+                count = 0;
+                if (first >= oldest)
+                {
+                    count = stream_download.end_index - first;
+                    if (count > STREAM_HISTORY_CHUNK)
+                        count = STREAM_HISTORY_CHUNK;
+                }
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    chunk.records[i] = history_get(history, tier, total - 1 - (first + i));
+                }
+            } while (seqlock_read_retry(&history_lock, seq));
+
+            if (count > 0)
+            {
+                chunk.header.channel = stream_download.channel;
+                chunk.header.tier = tier;
+                chunk.header.first_index = first;
+                chunk.header.end_index = stream_download.end_index;
+                usb_stream_send(STREAM_MSG_HISTORY, &chunk,
+                                sizeof(chunk.header) + count * sizeof(history_record_t));
+                stream_download.next_index += count;
+                stream_download.frames++;
+                continue;
             }
-            else if (current_state == STATE_MONITOR)
+        }
+        else
+        {
+            // Páginas como estão na flash (comprimidas); o host decodifica
+            const flash_log_page_header_t *page = flash_log_next(&stream_download.cursor);
+            if (page)
             {
-                current_state = STATE_MENU;
+                usb_stream_send(STREAM_MSG_ARCHIVE, page, FLASH_PAGE_SIZE);
+                stream_download.frames++;
+                continue;
             }
-            button_a_pressed = false;
         }
 
-        // Tratamento da interrupção do botão B
-        if (button_b_pressed)
+        stream_msg_end_t end = {.kind = stream_download.kind, .frames = stream_download.frames};
+        usb_stream_send(STREAM_MSG_END, &end, sizeof(end));
+        stream_download.kind = 0;
+    }
+}
+
+// Espelha a última tela enviada ao display: o ram_buffer só muda dentro de
+// draw_current_screen(), logo antes do flush
+void stream_mirror_pump(const ssd1306_t *ssd)
+{
+    if (!stream_mirror_on || !stream_mirror_pending || !time_reached(stream_mirror_next))
+        return;
+    if (!usb_stream_active() || usb_stream_pending() || stream_download.kind)
+        return;
+
+    static uint8_t payload[FRAME_MAX_PAYLOAD];
+    bool synced;
+    uint16_t length = display_mirror_encode(&stream_mirror, &ssd->ram_buffer[1], payload,
+                                            sizeof(payload), &synced);
+    if (length)
+        usb_stream_send(STREAM_MSG_MIRROR, payload, length);
+    stream_mirror_pending = !synced;
+    stream_mirror_next = make_timeout_time_ms(MIRROR_INTERVAL_MS);
+}
+
+// Comandos do host no modo binário
+void handle_stream_command(uint8_t type, const uint8_t *payload, uint16_t length)
+{
+    switch (type)
+    {
+    case STREAM_CMD_STOP:
+        usb_stream_stop();
+        printf("Modo texto\n");
+        break;
+
+    case STREAM_CMD_HISTORY:
+    {
+        stream_cmd_history_t request;
+        if (length != sizeof(request))
+            break;
+        memcpy(&request, payload, sizeof(request));
+        if (request.channel >= SENSOR_CHANNEL_COUNT || request.tier >= HISTORY_TIER_COUNT)
+            break;
+        stream_download = (StreamDownload){
+            .kind = STREAM_MSG_HISTORY, .channel = request.channel, .tier = request.tier};
+
+        // Fixa o trecho pelos índices absolutos: o que chegar depois fica fora
+        const history_channel_t *history = &channel_history[request.channel];
+        uint32_t seq;
+        do
+        {
+            seq = seqlock_read_begin(&history_lock);
+            stream_download.end_index = history_written(history, request.tier);
+            stream_download.next_index = stream_download.end_index - history_count(history, request.tier);
+        } while (seqlock_read_retry(&history_lock, seq));
+        break;
+    }
+
+    case STREAM_CMD_ARCHIVE:
+        stream_download = (StreamDownload){.kind = STREAM_MSG_ARCHIVE};
+        flash_log_cursor_init(&stream_download.cursor);
+        break;
+
+    case STREAM_CMD_MIRROR:
+    {
+        stream_cmd_mirror_t request;
+        if (length != sizeof(request))
+            break;
+        memcpy(&request, payload, sizeof(request));
+        stream_mirror_on = request.enable;
+        if (stream_mirror_on)
+        {
+            display_mirror_reset(&stream_mirror);
+            stream_mirror_pending = true;
+            stream_mirror_next = get_absolute_time();
+        }
+        break;
+    }
+    }
+}
+
+// Escravo Modbus RTU na UART0 (GPIO 0 = TX, GPIO 1 = RX), 8E1. As IRQs da
+// UART e do alarme de fim de quadro ficam neste núcleo e o mapa abaixo lê
+// só cópias sob os seqlocks, sem esperar o núcleo 1.
+//
+// Input registers (0x04), somente leitura; temperaturas em centésimos de
+// grau, com sinal:
+//   0x0000        quantidade de canais
+//   0x0001        pior alerta (0 normal, 1 atenção, 2 urgente)
+//   0x0002-0x0003 varreduras (palavra alta primeiro)
+//   0x0004        registros no nível da área de histórico
+//   0x0100 + 0x20 * canal:
+//     +0 temperatura, +1 leitura do ADC (Q12.4), +2 alerta
+//     +3 + 6 * janela (1 min, 15 min, 1 h, total): mínimo, máximo, média,
+//        desvio (só no total) e amostras (2 registradores); 0x8000 sem amostras
+//   0x1000 + 3 * idade: mínimo, máximo e média do registro do nível
+//     selecionado (idade 0 = mais novo); 0x8000 além do que está retido
+// Holding registers (0x03, 0x06, 0x10):
+//   0x0000-0x0002 limites normal, atenção e urgente, em ordem crescente
+//   0x0010        canal da área de histórico
+//   0x0011        nível da área de histórico (0 = 1 s ... 3 = 1 h)
+#define MODBUS_UART uart0
+#define MODBUS_TX_PIN 0
+#define MODBUS_RX_PIN 1
+#define MODBUS_BAUDRATE 19200
+#define MODBUS_ADDRESS 1
+
+#define MODBUS_CHANNEL_BASE 0x0100
+#define MODBUS_CHANNEL_STRIDE 0x20
+#define MODBUS_WINDOW_REGS 6
+#define MODBUS_CHANNEL_REGS (3 + MODBUS_WINDOW_REGS * (STATS_TOTAL + 1))
+#define MODBUS_HISTORY_BASE 0x1000
+#define MODBUS_HISTORY_REGS (3 * HISTORY_MAX_TIER_SIZE)
+#define MODBUS_THRESHOLDS 0x0000
+#define MODBUS_HISTORY_SELECT 0x0010
+#define MODBUS_NO_DATA 0x8000
+
+// Seleção da área de histórico (apenas IRQs do Modbus)
+uint8_t modbus_history_channel = 0;
+uint8_t modbus_history_tier = HISTORY_TIER_MINUTES;
+
+// Área de histórico: todos os registros pedidos numa só seção de leitura
+uint8_t modbus_read_history(uint16_t offset, uint16_t count, uint16_t *out)
+{
+    if (offset + count > MODBUS_HISTORY_REGS)
+        return MODBUS_EX_ILLEGAL_ADDRESS;
+
+    const history_channel_t *history = &channel_history[modbus_history_channel];
+    uint8_t tier = modbus_history_tier;
+    uint32_t seq;
+    do
+    {
+        seq = seqlock_read_begin(&history_lock);
+        int total = history_count(history, tier);
+        history_record_t record;
+        int loaded = -1;
+        for (uint16_t i = 0; i < count; i++)
         {
-            if (current_state == STATE_MENU)
+            int age = (offset + i) / 3;
+            if (age >= total)
             {
-                switch (selected_menu_item)
-                {
-                case MENU_MONITOR:
-                    current_state = STATE_MONITOR;
-                    break;
-                case MENU_HISTORY:
-                    current_state = STATE_HISTORY;
-                    break;
-                case MENU_CONFIG:
-                    current_state = STATE_CONFIG;
-                    break;
-                case MENU_STATS:
-                    current_state = STATE_STATS;
-                    break;
-                case MENU_ALERTS:
-                    current_state = STATE_ALERTS;
-                    break;
-                }
+                out[i] = MODBUS_NO_DATA;
+                continue;
+            }
+            if (age != loaded)
+            {
+                record = history_get(history, tier, age);
+                loaded = age;
             }
-            else if (current_state != STATE_SPLASH)
+            switch ((offset + i) % 3)
             {
-                current_state = STATE_MENU;
+            case 0:
+                out[i] = record.min;
+                break;
+            case 1:
+                out[i] = record.max;
+                break;
+            default:
+                out[i] = record.mean;
+                break;
             }
-            button_b_pressed = false;
         }
+    } while (seqlock_read_retry(&history_lock, seq));
+    return 0;
+}
 
-        float value = read_joystick_value();
+// Registrador do bloco de um canal; `summary` guarda a última janela lida
+bool modbus_channel_register(uint8_t channel, uint16_t offset, const SystemStatus *status,
+                             stream_stats_summary_t *summary, int *summary_window, uint16_t *out)
+{
+    if (offset >= MODBUS_CHANNEL_REGS)
+        return false;
+    switch (offset)
+    {
+    case 0:
+        *out = status->latest_temp[channel];
+        return true;
+    case 1:
+        *out = status->latest_adc_q4[channel];
+        return true;
+    case 2:
+        *out = status->channel_alert[channel];
+        return true;
+    }
+
+    int window = (offset - 3) / MODBUS_WINDOW_REGS;
+    if (window != *summary_window)
+    {
+        if (!stats_snapshot(channel, window, summary))
+            *summary = (stream_stats_summary_t){.min = INT16_MIN, .max = INT16_MIN, .mean = INT16_MIN};
+        *summary_window = window;
+    }
+    switch ((offset - 3) % MODBUS_WINDOW_REGS)
+    {
+    case 0:
+        *out = summary->min;
+        break;
+    case 1:
+        *out = summary->max;
+        break;
+    case 2:
+        *out = summary->mean;
+        break;
+    case 3:
+        *out = summary->stddev;
+        break;
+    case 4:
+        *out = summary->count >> 16;
+        break;
+    default:
+        *out = summary->count & 0xFFFF;
+        break;
+    }
+    return true;
+}
+
+uint8_t modbus_read_input(uint16_t address, uint16_t count, uint16_t *out)
+{
+    if (address >= MODBUS_HISTORY_BASE)
+        return modbus_read_history(address - MODBUS_HISTORY_BASE, count, out);
 
-        // Atualiza estatísticas
-        if (value < temp_stats.min_temp)
-            temp_stats.min_temp = value;
-        if (value > temp_stats.max_temp)
-            temp_stats.max_temp = value;
-        temp_stats.avg_temp = (temp_stats.avg_temp * (num_samples - 1) + value) / num_samples;
+    SystemStatus status;
+    status_snapshot(&status);
+    stream_stats_summary_t summary;
+    int summary_window = -1;
+    int summary_channel = -1;
 
-        // Gerenciamento de estados
-        switch (current_state)
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint16_t reg = address + i;
+        if (reg >= MODBUS_CHANNEL_BASE)
         {
-        case STATE_SPLASH:
-            if (to_ms_since_boot(get_absolute_time()) - splash_start_time > SPLASH_DURATION)
+            uint16_t channel = (reg - MODBUS_CHANNEL_BASE) / MODBUS_CHANNEL_STRIDE;
+            if (channel >= SENSOR_CHANNEL_COUNT)
+                return MODBUS_EX_ILLEGAL_ADDRESS;
+            if (channel != summary_channel)
             {
-                current_state = STATE_MENU;
+                summary_channel = channel;
+                summary_window = -1;
             }
-            draw_splash_screen(&ssd);
+            if (!modbus_channel_register(channel, (reg - MODBUS_CHANNEL_BASE) % MODBUS_CHANNEL_STRIDE,
+                                         &status, &summary, &summary_window, &out[i]))
+                return MODBUS_EX_ILLEGAL_ADDRESS;
+            continue;
+        }
+        switch (reg)
+        {
+        case 0x0000:
+            out[i] = SENSOR_CHANNEL_COUNT;
             break;
-
-        case STATE_MENU:
-            draw_menu_screen(&ssd);
+        case 0x0001:
+            out[i] = status.current_alert;
             break;
-
-        case STATE_MONITOR:
-            draw_graph_screen(&ssd);
+        case 0x0002:
+            out[i] = status.scans >> 16;
             break;
-
-        case STATE_HISTORY:
-            draw_history_screen(&ssd);
+        case 0x0003:
+            out[i] = status.scans & 0xFFFF;
             break;
-
-        case STATE_CONFIG:
-            draw_config_screen(&ssd);
+        case 0x0004:
+        {
+            uint32_t seq;
+            do
+            {
+                seq = seqlock_read_begin(&history_lock);
+                out[i] = history_count(&channel_history[modbus_history_channel], modbus_history_tier);
+            } while (seqlock_read_retry(&history_lock, seq));
             break;
+        }
+        default:
+            return MODBUS_EX_ILLEGAL_ADDRESS;
+        }
+    }
+    return 0;
+}
 
-        case STATE_STATS:
-            draw_stats_screen(&ssd);
-            break;
+// Imagem dos holding registers, para ler e validar escritas de uma vez
+typedef struct
+{
+    uint16_t thresholds[3];
+    uint16_t history_select[2];
+} ModbusHolding;
 
-        case STATE_ALERTS:
-            draw_alerts_screen(&ssd);
-            break;
+uint16_t *modbus_holding_register(ModbusHolding *holding, uint16_t reg)
+{
+    if (reg >= MODBUS_THRESHOLDS && reg < MODBUS_THRESHOLDS + 3)
+        return &holding->thresholds[reg - MODBUS_THRESHOLDS];
+    if (reg >= MODBUS_HISTORY_SELECT && reg < MODBUS_HISTORY_SELECT + 2)
+        return &holding->history_select[reg - MODBUS_HISTORY_SELECT];
+    return NULL;
+}
+
+void modbus_holding_load(ModbusHolding *holding)
+{
+    AlertConfig config;
+    alert_config_snapshot(&config);
+    holding->thresholds[0] = config.temp_normal_max;
+    holding->thresholds[1] = config.temp_attention_max;
+    holding->thresholds[2] = config.temp_urgent_max;
+    holding->history_select[0] = modbus_history_channel;
+    holding->history_select[1] = modbus_history_tier;
+}
+
+uint8_t modbus_read_holding(uint16_t address, uint16_t count, uint16_t *out)
+{
+    ModbusHolding holding;
+    modbus_holding_load(&holding);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        const uint16_t *reg = modbus_holding_register(&holding, address + i);
+        if (!reg)
+            return MODBUS_EX_ILLEGAL_ADDRESS;
+        out[i] = *reg;
+    }
+    return 0;
+}
+
+// Aplica a escrita inteira ou nada; os três limites, já validados, são
+// publicados juntos sob config_lock.
+uint8_t modbus_write_holding(uint16_t address, uint16_t count, const uint16_t *values)
+{
+    ModbusHolding holding;
+    modbus_holding_load(&holding);
+    for (uint16_t i = 0; i < count; i++)
+    {
+        uint16_t *reg = modbus_holding_register(&holding, address + i);
+        if (!reg)
+            return MODBUS_EX_ILLEGAL_ADDRESS;
+        *reg = values[i];
+    }
+
+    temp_centi_t normal = holding.thresholds[0];
+    temp_centi_t attention = holding.thresholds[1];
+    temp_centi_t urgent = holding.thresholds[2];
+    if (normal > attention || attention > urgent ||
+        holding.history_select[0] >= SENSOR_CHANNEL_COUNT ||
+        holding.history_select[1] >= HISTORY_TIER_COUNT)
+        return MODBUS_EX_ILLEGAL_VALUE;
+
+    seqlock_write_begin(&config_lock);
+    alert_config.temp_normal_max = normal;
+    alert_config.temp_attention_max = attention;
+    alert_config.temp_urgent_max = urgent;
+    seqlock_write_end(&config_lock);
+    modbus_history_channel = holding.history_select[0];
+    modbus_history_tier = holding.history_select[1];
+    events_post(EVENT_CONFIG);
+    return 0;
+}
+
+const modbus_map_t modbus_map = {
+    .read_input = modbus_read_input,
+    .read_holding = modbus_read_holding,
+    .write_holding = modbus_write_holding};
+
+void print_modbus_report(void)
+{
+    const modbus_rtu_stats_t *stats = modbus_rtu_stats();
+    printf("Modbus: endereco %d, %d bps, %lu pedidos, %lu excecoes, %lu erros de CRC, "
+           "%lu descartados, %lu ocupado\n",
+           MODBUS_ADDRESS, MODBUS_BAUDRATE, (unsigned long)stats->requests,
+           (unsigned long)stats->exceptions, (unsigned long)stats->crc_errors,
+           (unsigned long)stats->discarded, (unsigned long)stats->busy);
+    printf("Modbus: latencia %lu us (pior %lu us)\n",
+           (unsigned long)stats->last_latency_us, (unsigned long)stats->max_latency_us);
+}
+
+// Comandos pela USB para a calibração de campo do canal exibido:
+//   cal <temperatura>   registra a temperatura do termômetro de referência
+//   cal list            lista os pontos (leitura do modelo -> referência)
+//   cal clear           remove a calibração
+// e para o arquivo na flash:
+//   log                 ocupação, retenção e vida útil
+// e para o protocolo binário (lib/usb_stream):
+//   stream              passa a porta para o modo binário
+// e para o escravo Modbus:
+//   modbus              contadores e latência das respostas
+// e para a instrumentação (lib/probe.h):
+//   diag                mínimo, média, p99, máximo e histograma de cada seção
+//   diag reset          zera as seções
+//   trace               últimos eventos dos dois núcleos
+//   mem                 pilhas dos dois núcleos e heap (lib/mem_usage.h)
+#define COMMAND_LINE_SIZE 32
+
+void print_probe_report(void)
+{
+    if (!PROBE_ENABLED)
+    {
+        printf("Diag: instrumentacao desligada (PROBE_ENABLED 0)\n");
+        return;
+    }
+    printf("Diag: ciclos a %lu Hz; faixas do histograma em potencias de 2\n",
+           (unsigned long)hal_cycles_hz());
+    for (uint8_t id = 0; id < PROBE_COUNT; id++)
+    {
+        const probe_stat_t *stat = &probes[id];
+        const char *unit = probe_info[id].cycles ? "ciclos" : "us";
+        printf("  %-15s n %lu min %lu media %lu p99 %lu max %lu %s\n", probe_info[id].name,
+               (unsigned long)stat->count, (unsigned long)stat->min,
+               (unsigned long)probe_mean(stat), (unsigned long)probe_percentile(stat, 990),
+               (unsigned long)stat->max, unit);
+        if (stat->count == 0)
+            continue;
+        printf("  %-15s", "");
+        for (uint8_t k = 0; k < PROBE_HIST_BINS; k++)
+        {
+            if (stat->hist[k])
+                printf(" <%lu:%lu", (unsigned long)(1u << k), (unsigned long)stat->hist[k]);
+        }
+        printf("\n");
+    }
+}
+
+void print_memory_report(void)
+{
+    mem_usage_t usage;
+    mem_usage_read(&usage);
+    printf("Memoria: estatica %lu bytes, historico %u bytes por canal\n",
+           (unsigned long)usage.static_bytes, (unsigned)CHANNEL_MEMORY_BYTES);
+    printf("  heap     pico %6lu de %6lu bytes, em uso %lu\n", (unsigned long)usage.heap.peak,
+           (unsigned long)usage.heap.size, (unsigned long)usage.heap_in_use);
+    for (uint core = 0; core < 2; core++)
+    {
+        const mem_usage_area_t *stack = &usage.stack[core];
+        printf("  pilha %u  pico %6lu de %6lu bytes%s\n", core, (unsigned long)stack->peak,
+               (unsigned long)stack->size, stack->peak >= stack->size ? " (estouro?)" : "");
+    }
+}
+
+void print_probe_trace(void)
+{
+    static probe_event_t events[2 * PROBE_TRACE_SIZE];
+    uint count = probe_trace_collect(events, count_of(events));
+    printf("Trace: %u eventos\n", count);
+    for (uint i = 0; i < count; i++)
+    {
+        const probe_event_t *event = &events[i];
+        printf("  %10lu us nucleo %u %-10s %u\n", (unsigned long)event->time_us, event->core,
+               event->event < TRACE_COUNT ? trace_names[event->event] : "?", event->arg);
+    }
+}
+
+void handle_command(const char *line)
+{
+    char value_str[TEMP_STR_SIZE];
+    char reference_str[TEMP_STR_SIZE];
+
+    if (strcmp(line, "log") == 0)
+    {
+        print_archive_report();
+        return;
+    }
+    if (strcmp(line, "stream") == 0)
+    {
+        stream_begin();
+        return;
+    }
+    if (strcmp(line, "modbus") == 0)
+    {
+        print_modbus_report();
+        return;
+    }
+    if (strcmp(line, "diag") == 0)
+    {
+        print_probe_report();
+        print_memory_report();
+        return;
+    }
+    if (strcmp(line, "mem") == 0)
+    {
+        print_memory_report();
+        return;
+    }
+    if (strcmp(line, "diag reset") == 0)
+    {
+        probes_reset();
+        printf("Diag zerado\n");
+        return;
+    }
+    if (strcmp(line, "trace") == 0)
+    {
+        print_probe_trace();
+        return;
+    }
+    if (strncmp(line, "cal ", 4) != 0)
+    {
+        printf("Comando desconhecido: %s\n", line);
+        return;
+    }
+    const char *argument = line + 4;
+
+    if (strcmp(argument, "clear") == 0)
+    {
+        printf(calibration_clear() ? "Calibracao removida\n" : "Falha ao gravar a calibracao\n");
+    }
+    else if (strcmp(argument, "list") == 0)
+    {
+        const temp_calibration_point_t *points;
+        uint count = calibration_points(&points);
+        printf("Calibracao: %u pontos\n", count);
+        for (uint i = 0; i < count; i++)
+        {
+            printf("  %s -> %s C\n", temperature_format(value_str, points[i].measured, 2),
+                   temperature_format(reference_str, points[i].reference, 2));
+        }
+    }
+    else
+    {
+        temp_centi_t reference;
+        if (!temperature_parse(argument, &reference))
+        {
+            printf("Temperatura invalida: %s\n", argument);
+            return;
+        }
+        temp_centi_t measured = temperature_model_from_adc_q4(channel_adc_q4(selected_channel));
+        if (calibration_add_point(measured, reference))
+        {
+            printf("Ponto %s -> %s C gravado\n", temperature_format(value_str, measured, 2),
+                   temperature_format(reference_str, reference, 2));
+        }
+        else
+        {
+            printf("Falha ao gravar o ponto (maximo %d)\n", TEMP_CALIBRATION_MAX_POINTS);
+        }
+    }
+}
+
+// Lê os caracteres disponíveis na USB sem bloquear o loop principal
+void poll_serial_commands(void)
+{
+    static char line[COMMAND_LINE_SIZE];
+    static uint length = 0;
+    int c;
+
+    while ((c = getchar_timeout_us(0)) != PICO_ERROR_TIMEOUT)
+    {
+        if (usb_stream_active())
+        {
+            uint8_t type;
+            const uint8_t *payload;
+            uint16_t payload_length;
+            if (usb_stream_receive(c, &type, &payload, &payload_length))
+                handle_stream_command(type, payload, payload_length);
+            continue;
+        }
+
+        if (c == '\r' || c == '\n')
+        {
+            line[length] = '\0';
+            if (length > 0)
+                handle_command(line);
+            length = 0;
+        }
+        else if (length < COMMAND_LINE_SIZE - 1)
+        {
+            line[length++] = c;
+        }
+    }
+}
+
+// Próximo instante em que o laço precisa acordar sem evento: fim da tela
+// inicial, leitura do joystick, fila da USB ou próximo quadro do espelho.
+// Um quadro adiado espera EVENT_DISPLAY; só depois do fim do DMA, com os
+// últimos bytes ainda no FIFO do I2C (`display_draining`, menos de 1 ms), o
+// laço volta a olhar o barramento sozinho.
+absolute_time_t next_wakeup(absolute_time_t next_joystick_poll, bool display_draining)
+{
+    absolute_time_t deadline = at_the_end_of_time;
+    if (current_state == STATE_SPLASH)
+    {
+        deadline = from_us_since_boot((uint64_t)(splash_start_time + SPLASH_DURATION + 1) * 1000);
+    }
+    if (screen_uses_joystick(current_state))
+    {
+        deadline = absolute_time_min(deadline, next_joystick_poll);
+    }
+    if (display_draining || stream_download.kind || usb_stream_pending())
+    {
+        deadline = absolute_time_min(deadline, make_timeout_time_ms(1));
+    }
+    if (stream_mirror_on && stream_mirror_pending)
+    {
+        deadline = absolute_time_min(deadline, stream_mirror_next);
+    }
+    return deadline;
+}
+
+// Callbacks das IRQs do display e da USB: apenas acordam o laço
+void display_flush_done(void *context)
+{
+#if PROBE_ENABLED
+    PROBE_VALUE(&probes[PROBE_FLUSH_BUS], hal_time_us() - display_flush_start_us);
+#endif
+    PROBE_TRACE(TRACE_FLUSH_DONE, 0);
+    events_post(EVENT_DISPLAY);
+}
+
+void serial_chars_available(void *param)
+{
+    events_post(EVENT_SERIAL);
+}
+
+int main()
+{
+    // Pinta as pilhas antes de tudo, com o núcleo 1 ainda parado
+    mem_usage_init();
+
+    // Inicialização do sistema
+    stdio_init_all();
+    events_init();
+    hal_cycles_init(); // Relógio da instrumentação neste núcleo
+    stdio_set_chars_available_callback(serial_chars_available, NULL);
+
+    // Entradas do sensor e do joystick no ADC
+    hal_adc_init(ADC_CHANNEL_TEMP);
+    hal_adc_init(ADC_CHANNEL_SCROLL);
+
+    // Inicialização do display OLED no I2C
+    const hal_display_config_t display_config = {
+        .i2c = I2C_PORT,
+        .sda_pin = I2C_SDA,
+        .scl_pin = I2C_SCL,
+        .address = DISPLAY_ADDR,
+        .baudrate = 400 * 1000};
+    ssd1306_t ssd;
+    hal_display_init(&ssd, &display_config, display_flush_done, NULL);
+
+    // Botões A e B, com interrupção na borda de descida
+    hal_button_init(BUTTON_A_PIN, gpio_callback);
+    hal_button_init(BUTTON_B_PIN, gpio_callback);
+
+    // LEDs em PWM de 50 Hz
+    hal_led_init(LED_R);
+    hal_led_init(LED_G);
+    hal_led_init(LED_B);
+
+    // Inicializa o histórico e as estatísticas; a calibração da flash é
+    // aplicada sobre a tabela do sensor
+    monitor_init();
+    calibration_load();
+
+    // Procura a cabeça do arquivo antes de o núcleo 1 começar a produzir
+    flash_log_init(ARCHIVE_FIELDS);
+
+    // Aquisição e alertas rodam no núcleo 1; este núcleo cuida só da interface
+    hal_sensors_start(&sensor_config, temperature_scan_done);
+
+    // Escravo Modbus: responde nas IRQs deste núcleo, fora do laço principal
+    const modbus_rtu_config_t modbus_config = {
+        .uart = MODBUS_UART,
+        .tx_pin = MODBUS_TX_PIN,
+        .rx_pin = MODBUS_RX_PIN,
+        .baudrate = MODBUS_BAUDRATE,
+        .parity = UART_PARITY_EVEN,
+        .address = MODBUS_ADDRESS};
+    modbus_rtu_init(&modbus_config, &modbus_map);
+
+    printf("Canais: %d, memoria por canal: %u bytes, total: %u bytes\n",
+           SENSOR_CHANNEL_COUNT, (unsigned)CHANNEL_MEMORY_BYTES,
+           (unsigned)(CHANNEL_MEMORY_BYTES * SENSOR_CHANNEL_COUNT));
+    print_archive_report();
+    uint32_t last_scan_report = 0;
+
+    // Loop principal, orientado a eventos: o núcleo dorme em WFE até uma IRQ
+    // marcar um evento (botões, varredura do núcleo 1, fim do DMA do display,
+    // USB ou Modbus) e só redesenha a tela quando algo que ela mostra mudou.
+    // Sem eventos acorda apenas no prazo dado por next_wakeup().
+    bool redraw = true;
+    bool display_pending = false;   // Quadro adiado até o anterior sair
+    bool display_in_flight = false; // DMA do último quadro ainda sem EVENT_DISPLAY
+    absolute_time_t next_joystick_poll = get_absolute_time();
+    while (true)
+    {
+        uint32_t events = events_wait(
+            next_wakeup(next_joystick_poll, display_pending && !display_in_flight));
+        PROBE_INTERVAL(&probes[PROBE_LOOP], 0);
+        if (events & EVENT_DISPLAY)
+            display_in_flight = false;
+
+        // Botões e fim da tela inicial
+        if (handle_buttons())
+            redraw = true;
+        if (update_splash())
+            redraw = true;
+
+        // Joystick: zoom do gráfico no monitor, rolagem no histórico
+        if (screen_uses_joystick(current_state) && time_reached(next_joystick_poll))
+        {
+            next_joystick_poll = make_timeout_time_ms(JOYSTICK_POLL_MS);
+            if (current_state == STATE_MONITOR ? update_history_zoom() : update_history_scroll())
+                redraw = true;
+        }
+
+        if ((events & EVENT_CONFIG) && screen_shows_config(current_state))
+        {
+            redraw = true;
+        }
+
+        // Sem custo quando não há caracteres; o evento só garante o despertar
+        poll_serial_commands();
+
+        // Varreduras concluídas entregues pelo núcleo 1
+        SampleRecord record;
+        while (spsc_ring_pop(&sample_ring, &record))
+        {
+            new_temperature_available = true;
+            if (usb_stream_active())
+                stream_send_sample(&record);
+        }
+
+        // Minutos fechados: comprimidos em RAM e gravados uma página por vez
+        ArchiveRecord archive;
+        while (spsc_ring_pop(&archive_ring, &archive))
+        {
+            flash_log_append((const int16_t *)&archive);
         }
 
         if (new_temperature_available)
         {
             new_temperature_available = false;
-            // Força atualização do display quando há nova temperatura
-            ssd1306_send_data(&ssd);
+
+            if (usb_stream_active())
+                stream_send_alerts();
+
+            // Relata o custo da varredura a cada minuto pela USB (no modo
+            // binário, estatísticas e contadores em quadros)
+            const sensor_scan_state_t *scan = sensor_scan_state();
+            if (scan->scans - last_scan_report >= 60)
+            {
+                last_scan_report = scan->scans;
+                if (usb_stream_active())
+                {
+                    stream_send_minute_report();
+                }
+                else
+                {
+                    printf("Varredura: %d canais, %lu us (pior %lu us), overruns %lu\n",
+                           SENSOR_CHANNEL_COUNT, (unsigned long)scan->last_scan_us,
+                           (unsigned long)scan->max_scan_us, (unsigned long)scan->overruns);
+                }
+            }
+            if (screen_shows_samples(current_state))
+                redraw = true;
         }
 
-        sleep_ms(50); // Pequeno delay para não sobrecarregar o processador
+        // Redesenha só com mudanças; com o quadro anterior ainda no
+        // barramento, o novo espera o fim do DMA em vez de bloquear o laço
+        if (redraw || display_pending)
+        {
+            if (hal_display_busy(&ssd))
+            {
+                display_pending = true;
+            }
+            else
+            {
+                draw_current_screen(&ssd);
+#if PROBE_ENABLED
+                display_flush_start_us = hal_time_us();
+#endif
+                PROBE_BEGIN(flush_start);
+                bool sent = hal_display_flush(&ssd);
+                PROBE_END(&probes[PROBE_FLUSH_CALL], flush_start);
+                if (sent)
+                {
+                    PROBE_INTERVAL(&probes[PROBE_FRAME], 0);
+                    PROBE_TRACE(TRACE_FLUSH, ssd.last_flush_bytes);
+                    stream_mirror_pending = true;
+                    display_in_flight = true;
+                }
+                display_pending = false;
+            }
+            redraw = false;
+        }
+
+        // Protocolo binário: gera o download e o espelho e entrega à USB o
+        // que couber
+        stream_download_pump();
+        stream_mirror_pump(&ssd);
+        usb_stream_pump();
     }
 
     return 0;
 }
+
+#endif // MONITOR_APP_ONLY
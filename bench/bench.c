@@ -0,0 +1,69 @@
+#include "bench.h"
+#include <stdio.h>
+
+// Corpo vazio: mede o custo do laço e da chamada, descontado de cada caso
+static void bench_empty(uint32_t i)
+{
+    (void)i;
+}
+
+static const bench_case_t bench_overhead = {.name = "overhead", .run = bench_empty};
+
+static uint32_t bench_batch(const bench_case_t *bench, uint32_t batch, uint32_t *counter)
+{
+    uint32_t start = bench_ticks();
+    for (uint32_t n = 0; n < batch; n++)
+    {
+        bench->run((*counter)++);
+    }
+    return (bench_ticks() - start) & bench_ticks_mask();
+}
+
+// Ticks por operação: menor de BENCH_REPEATS lotes grandes o bastante para
+// a resolução do contador, e pequenos o bastante para ele não dar a volta
+static double bench_measure(const bench_case_t *bench, uint32_t *batch_out)
+{
+    uint32_t min_ticks = (uint32_t)((uint64_t)BENCH_MIN_BATCH_US * bench_ticks_hz() / 1000000);
+    uint32_t max_ticks = bench_ticks_mask() / 2;
+    uint32_t counter = 0;
+
+    uint32_t batch = 1;
+    uint32_t ticks = bench_batch(bench, batch, &counter);
+    while (ticks < min_ticks && ticks < max_ticks / 4 && batch < (1u << 24))
+    {
+        batch *= 2;
+        ticks = bench_batch(bench, batch, &counter);
+    }
+
+    uint32_t best = ticks;
+    for (uint8_t r = 1; r < BENCH_REPEATS; r++)
+    {
+        ticks = bench_batch(bench, batch, &counter);
+        if (ticks < best)
+            best = ticks;
+    }
+    *batch_out = batch;
+    return (double)best / batch;
+}
+
+void bench_run(const bench_case_t *cases, size_t count)
+{
+    uint32_t batch;
+    double overhead = bench_measure(&bench_overhead, &batch);
+
+    for (size_t c = 0; c < count; c++)
+    {
+        const bench_case_t *bench = &cases[c];
+        if (bench->setup)
+            bench->setup();
+        double ticks = bench_measure(bench, &batch) - overhead;
+        if (ticks < 0)
+            ticks = 0;
+
+        printf("{\"platform\":\"%s\",\"bench\":\"%s\",\"ns_per_op\":%.1f,\"ticks_per_op\":%.1f,\"batch\":%lu",
+               bench_platform(), bench->name, ticks * 1e9 / bench_ticks_hz(), ticks, (unsigned long)batch);
+        if (bench->frame_bytes)
+            printf(",\"flush_bytes\":%ld", (long)bench->frame_bytes());
+        printf("}\n");
+    }
+}
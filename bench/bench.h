@@ -0,0 +1,42 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// Micro-benchmarks do desenho no display.
+//
+// Cada caso roda em lotes: o tamanho do lote dobra até o lote levar pelo
+// menos BENCH_MIN_BATCH_US, e o resultado é o menor lote de BENCH_REPEATS
+// (o menos perturbado por IRQs e pelo sistema), dividido pelo tamanho. O
+// contador vem da plataforma: ciclos do SysTick no RP2040, nanossegundos do
+// relógio monotônico no PC.
+//
+// A saída é uma linha JSON por caso, para comparar versões com
+// tools/bench_compare.py:
+//   {"platform":"rp2040","bench":"ssd1306_fill","ns_per_op":1234.5,
+//    "ticks_per_op":154.3,"batch":64,"flush_bytes":1024}
+// flush_bytes só aparece nos casos que desenham um quadro inteiro.
+
+#define BENCH_REPEATS 7
+#define BENCH_MIN_BATCH_US 2000
+
+typedef struct
+{
+    const char *name;
+    void (*setup)(void);          // Antes das medidas (opcional)
+    void (*run)(uint32_t i);      // Uma operação; `i` varia os dados
+    int32_t (*frame_bytes)(void); // Bytes enviados num quadro típico (opcional)
+} bench_case_t;
+
+// Contador da plataforma (bench_host.c, bench_pico.c): cresce a
+// bench_ticks_hz() e volta a zero depois de bench_ticks_mask()
+uint32_t bench_ticks(void);
+uint32_t bench_ticks_mask(void);
+uint32_t bench_ticks_hz(void);
+const char *bench_platform(void);
+
+void bench_run(const bench_case_t *cases, size_t count);
+
+#endif // BENCH_H
@@ -0,0 +1,35 @@
+#include "bench.h"
+#include <time.h>
+
+// PC: nanossegundos do relógio monotônico
+
+uint32_t bench_ticks(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + now.tv_nsec);
+}
+
+uint32_t bench_ticks_mask(void)
+{
+    return 0xFFFFFFFFu;
+}
+
+uint32_t bench_ticks_hz(void)
+{
+    return 1000000000u;
+}
+
+const char *bench_platform(void)
+{
+    return "host";
+}
+
+void bench_platform_init(void)
+{
+}
+
+bool bench_platform_again(void)
+{
+    return false;
+}
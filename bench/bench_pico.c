@@ -0,0 +1,51 @@
+#include "bench.h"
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hal.h"
+
+// RP2040: ciclos do SysTick (hal_cycles). A 125 MHz dá a volta a cada
+// 134 ms; os lotes ficam bem abaixo disso.
+
+uint32_t bench_ticks(void)
+{
+    return hal_cycles();
+}
+
+uint32_t bench_ticks_mask(void)
+{
+    return HAL_CYCLES_MASK;
+}
+
+uint32_t bench_ticks_hz(void)
+{
+    return hal_cycles_hz();
+}
+
+const char *bench_platform(void)
+{
+    return "rp2040";
+}
+
+void bench_platform_init(void)
+{
+    stdio_init_all();
+    hal_cycles_init();
+
+    // Espera o terminal abrir a porta para não perder o resultado
+    while (!stdio_usb_connected())
+    {
+        sleep_ms(100);
+    }
+}
+
+// Repete a cada linha recebida pela USB
+bool bench_platform_again(void)
+{
+    printf("# enter para repetir\n");
+    int c;
+    do
+    {
+        c = getchar();
+    } while (c != '\n' && c != '\r');
+    return true;
+}
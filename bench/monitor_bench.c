@@ -0,0 +1,193 @@
+// Benchmarks do desenho: primitivas do ssd1306, gráficos e cada tela.
+//
+// O mesmo programa roda no PC (sim/CMakeLists.txt, alvo monitor_bench) e na
+// placa (alvo System_Monitor_Temp_PV_bench, resultado pela USB). Primeiro
+// alimenta duas horas de varreduras sintéticas para encher o histórico e as
+// estatísticas; depois mede, para cada tela:
+//   screen_<tela>_full    redesenho completo (troca de tela)
+//   screen_<tela>_update  uma varredura nova e o redesenho incremental
+// com os bytes que o quadro correspondente envia ao display.
+//
+// Como o simulador, inclui a aplicação compilada com MONITOR_APP_ONLY.
+
+#include "System_Monitor_Temp_PV.c"
+#include "bench.h"
+
+#define BENCH_WARMUP_SCANS 7200 // Duas horas: todos os níveis do histórico com dados
+#define BENCH_GRAPH_POINTS 64
+#define BENCH_GRAPH_BARS 16
+
+// Início e repetição, da plataforma (bench_host.c, bench_pico.c)
+void bench_platform_init(void);
+bool bench_platform_again(void);
+
+static ssd1306_t ssd;
+static Graph bench_graph;
+static int16_t bench_values[BENCH_GRAPH_POINTS];
+static uint32_t scans;
+
+// Uma varredura: rampa de 1,6 mil passos Q12.4 em torno do meio da escala
+static void bench_feed(uint32_t i)
+{
+    uint16_t adc_q4[SENSOR_CHANNEL_COUNT];
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        adc_q4[ch] = (2048u << 4) + (((i + ch * 7) & 63) << 6);
+    }
+    temperature_scan_done(adc_q4, ++scans);
+
+    SampleRecord record;
+    while (spsc_ring_pop(&sample_ring, &record))
+        ;
+    ArchiveRecord archive;
+    while (spsc_ring_pop(&archive_ring, &archive))
+        ;
+}
+
+static void bench_fill(uint32_t i)
+{
+    ssd1306_fill(&ssd, i & 1);
+}
+
+static void bench_line(uint32_t i)
+{
+    uint8_t y = i & 63;
+    ssd1306_line(&ssd, 0, y, 127, 63 - y, true);
+}
+
+static void bench_string(uint32_t i)
+{
+    ssd1306_draw_string(&ssd, "Temp: 23.45 C", 0, (i & 7) * 8);
+}
+
+static void bench_string_large(uint32_t i)
+{
+    ssd1306_draw_string_large(&ssd, "23.4C", 0, (i & 3) * 12);
+}
+
+static void bench_graph_setup(void)
+{
+    bench_graph = create_graph(0, 10000);
+    for (uint8_t n = 0; n < BENCH_GRAPH_POINTS; n++)
+    {
+        bench_values[n] = 5000 + ((n * 37) % 41 - 20) * 200;
+    }
+}
+
+static void bench_line_graph(uint32_t i)
+{
+    draw_line_graph(&ssd, &bench_graph, bench_values, BENCH_GRAPH_POINTS);
+}
+
+static void bench_bar_graph(uint32_t i)
+{
+    draw_bar_graph(&ssd, &bench_graph, bench_values, BENCH_GRAPH_BARS);
+}
+
+static void bench_grid(uint32_t i)
+{
+    draw_grid(&ssd, &bench_graph);
+}
+
+static void bench_screen_full(SystemState state)
+{
+    current_state = state;
+    widget_screen_invalidate();
+    draw_current_screen(&ssd);
+}
+
+static void bench_screen_update(SystemState state, uint32_t i)
+{
+    current_state = state;
+    bench_feed(i);
+    draw_current_screen(&ssd);
+}
+
+// Bytes do quadro ao chegar na tela vindo de outra (menu, ou splash para o menu)
+static int32_t bench_frame_full(SystemState state)
+{
+    bench_screen_full(state == STATE_MENU ? STATE_SPLASH : STATE_MENU);
+    hal_display_flush(&ssd);
+    current_state = state;
+    draw_current_screen(&ssd);
+    hal_display_flush(&ssd);
+    return ssd.last_flush_bytes;
+}
+
+// Bytes do quadro de uma varredura nova, com a tela já no display
+static int32_t bench_frame_update(SystemState state)
+{
+    current_state = state;
+    draw_current_screen(&ssd);
+    hal_display_flush(&ssd);
+    bench_feed(scans);
+    draw_current_screen(&ssd);
+    hal_display_flush(&ssd);
+    return ssd.last_flush_bytes;
+}
+
+#define BENCH_SCREEN(state, screen)                                                         \
+    static void bench_##screen##_full(uint32_t i) { bench_screen_full(state); }             \
+    static void bench_##screen##_update(uint32_t i) { bench_screen_update(state, i); }      \
+    static int32_t bench_##screen##_full_bytes(void) { return bench_frame_full(state); }    \
+    static int32_t bench_##screen##_update_bytes(void) { return bench_frame_update(state); }
+
+#define BENCH_SCREEN_CASES(screen)                                                          \
+    {.name = "screen_" #screen "_full", .run = bench_##screen##_full,                       \
+     .frame_bytes = bench_##screen##_full_bytes},                                           \
+    {.name = "screen_" #screen "_update", .run = bench_##screen##_update,                   \
+     .frame_bytes = bench_##screen##_update_bytes}
+
+BENCH_SCREEN(STATE_SPLASH, splash)
+BENCH_SCREEN(STATE_MENU, menu)
+BENCH_SCREEN(STATE_MONITOR, monitor)
+BENCH_SCREEN(STATE_HISTORY, history)
+BENCH_SCREEN(STATE_CONFIG, config)
+BENCH_SCREEN(STATE_STATS, stats)
+BENCH_SCREEN(STATE_ALERTS, alerts)
+BENCH_SCREEN(STATE_DIAG, diag)
+
+static const bench_case_t bench_cases[] = {
+    {.name = "ssd1306_fill", .run = bench_fill},
+    {.name = "ssd1306_line", .run = bench_line},
+    {.name = "ssd1306_draw_string", .run = bench_string},
+    {.name = "ssd1306_draw_string_large", .run = bench_string_large},
+    {.name = "draw_line_graph", .setup = bench_graph_setup, .run = bench_line_graph},
+    {.name = "draw_bar_graph", .setup = bench_graph_setup, .run = bench_bar_graph},
+    {.name = "draw_grid", .setup = bench_graph_setup, .run = bench_grid},
+    {.name = "scan_done", .run = bench_feed},
+    BENCH_SCREEN_CASES(splash),
+    BENCH_SCREEN_CASES(menu),
+    BENCH_SCREEN_CASES(monitor),
+    BENCH_SCREEN_CASES(history),
+    BENCH_SCREEN_CASES(config),
+    BENCH_SCREEN_CASES(stats),
+    BENCH_SCREEN_CASES(alerts),
+    BENCH_SCREEN_CASES(diag),
+};
+
+int main(void)
+{
+    bench_platform_init();
+    events_init();
+    monitor_init();
+
+    const hal_display_config_t display_config = {
+        .i2c = I2C_PORT,
+        .sda_pin = I2C_SDA,
+        .scl_pin = I2C_SCL,
+        .address = DISPLAY_ADDR,
+        .baudrate = 400 * 1000};
+    hal_display_init(&ssd, &display_config, NULL, NULL);
+
+    for (uint32_t i = 0; i < BENCH_WARMUP_SCANS; i++)
+    {
+        bench_feed(i);
+    }
+
+    do
+    {
+        bench_run(bench_cases, count_of(bench_cases));
+    } while (bench_platform_again());
+    return 0;
+}
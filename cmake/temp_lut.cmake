@@ -0,0 +1,34 @@
+# Tabela ADC -> temperatura gerada a partir do modelo do sensor, incluída pelo
+# firmware e pelo simulador (sim/). Define TEMP_LUT_HEADER, gerado em
+# ${CMAKE_CURRENT_BINARY_DIR}/generated.
+#
+# linear: tensão proporcional (faixa TEMP_SENSOR_T_MIN..T_MAX, ex: joystick do Wokwi)
+# beta / steinhart: NTC em divisor com TEMP_SENSOR_R_SERIES (ver tools/gen_temp_lut.py)
+set(TEMP_SENSOR_MODEL linear CACHE STRING "Modelo do sensor: linear, beta ou steinhart")
+set_property(CACHE TEMP_SENSOR_MODEL PROPERTY STRINGS linear beta steinhart)
+set(TEMP_SENSOR_T_MIN 0 CACHE STRING "Modelo linear: temperatura em 0 V")
+set(TEMP_SENSOR_T_MAX 100 CACHE STRING "Modelo linear: temperatura no fundo de escala")
+set(TEMP_SENSOR_R_SERIES 10000 CACHE STRING "NTC: resistor série do divisor (ohms)")
+set(TEMP_SENSOR_NTC_POSITION low CACHE STRING "NTC: low (NTC no GND) ou high (NTC no 3V3)")
+set(TEMP_SENSOR_R0 10000 CACHE STRING "NTC Beta: resistência nominal (ohms)")
+set(TEMP_SENSOR_T0 25 CACHE STRING "NTC Beta: temperatura da resistência nominal")
+set(TEMP_SENSOR_BETA 3950 CACHE STRING "NTC Beta: coeficiente B")
+set(TEMP_SENSOR_SH_A 1.009249522e-03 CACHE STRING "NTC Steinhart-Hart: A")
+set(TEMP_SENSOR_SH_B 2.378405444e-04 CACHE STRING "NTC Steinhart-Hart: B")
+set(TEMP_SENSOR_SH_C 2.019202697e-07 CACHE STRING "NTC Steinhart-Hart: C")
+
+find_package(Python3 REQUIRED COMPONENTS Interpreter)
+set(TEMP_LUT_HEADER ${CMAKE_CURRENT_BINARY_DIR}/generated/temp_lut.h)
+add_custom_command(
+    OUTPUT ${TEMP_LUT_HEADER}
+    COMMAND ${CMAKE_COMMAND} -E make_directory ${CMAKE_CURRENT_BINARY_DIR}/generated
+    COMMAND ${Python3_EXECUTABLE} ${CMAKE_CURRENT_LIST_DIR}/../tools/gen_temp_lut.py
+        --out ${TEMP_LUT_HEADER}
+        --model ${TEMP_SENSOR_MODEL}
+        --t-min ${TEMP_SENSOR_T_MIN} --t-max ${TEMP_SENSOR_T_MAX}
+        --r-series ${TEMP_SENSOR_R_SERIES} --ntc-position ${TEMP_SENSOR_NTC_POSITION}
+        --r0 ${TEMP_SENSOR_R0} --t0 ${TEMP_SENSOR_T0} --beta ${TEMP_SENSOR_BETA}
+        --sh-a ${TEMP_SENSOR_SH_A} --sh-b ${TEMP_SENSOR_SH_B} --sh-c ${TEMP_SENSOR_SH_C}
+    DEPENDS ${CMAKE_CURRENT_LIST_DIR}/../tools/gen_temp_lut.py
+    COMMENT "Gerando a tabela ADC -> temperatura (${TEMP_SENSOR_MODEL})"
+)
@@ -0,0 +1,131 @@
+#include "adc_sampler.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/sync.h"
+
+// Anel de amostras brutas; o alinhamento permite o wrap automático do DMA
+static uint16_t raw_ring[(1u << ADC_SAMPLER_RAW_LOG2) / sizeof(uint16_t)]
+    __attribute__((aligned(1u << ADC_SAMPLER_RAW_LOG2)));
+
+static struct
+{
+    uint input;
+    uint oversample_log2;
+    int dma_channel;
+    adc_sampler_burst_callback_t callback;  // Não nulo durante uma rajada
+    void *context;
+    spin_lock_t *lock;                      // Serializa a troca de entrada do ADC
+} sampler = {.dma_channel = -1};
+
+// Converte a soma de 2^oversample_log2 amostras para Q12.4
+static inline uint16_t adc_sampler_decimate(uint32_t sum)
+{
+    if (sampler.oversample_log2 >= ADC_SAMPLER_FRAC_BITS)
+        return sum >> (sampler.oversample_log2 - ADC_SAMPLER_FRAC_BITS);
+    return sum << (ADC_SAMPLER_FRAC_BITS - sampler.oversample_log2);
+}
+
+static void __not_in_flash_func(adc_sampler_dma_handler)(void)
+{
+    uint ch = sampler.dma_channel;
+    dma_channel_acknowledge_irq1(ch);
+
+    uint32_t sum = dma_sniffer_get_data_accumulator();
+    dma_sniffer_set_data_accumulator(0);
+
+    // Fim da rajada: para o ADC e entrega a média ao solicitante, que pode
+    // iniciar a próxima rajada de dentro do próprio callback
+    uint32_t irq = spin_lock_blocking(sampler.lock);
+    adc_run(false);
+    adc_sampler_burst_callback_t callback = sampler.callback;
+    sampler.callback = NULL;
+    spin_unlock(sampler.lock, irq);
+    if (callback)
+        callback(adc_sampler_decimate(sum), sampler.context);
+}
+
+// Prepara o ADC e o canal DMA das rajadas, com `input` selecionada e cada
+// leitura a média de 2^oversample_log2 conversões
+void adc_sampler_init(uint input, uint oversample_log2)
+{
+    if (oversample_log2 > ADC_SAMPLER_MAX_OVERSAMPLE_LOG2)
+        oversample_log2 = ADC_SAMPLER_MAX_OVERSAMPLE_LOG2;
+    sampler.input = input;
+    sampler.oversample_log2 = oversample_log2;
+    sampler.callback = NULL;
+    if (!sampler.lock)
+        sampler.lock = spin_lock_init(spin_lock_claim_unused(true));
+
+    adc_gpio_init(26 + input);
+    adc_select_input(input);
+    // FIFO habilitado com DREQ a cada amostra, sem bit de erro e sem deslocamento
+    adc_fifo_setup(true, true, 1, false, false);
+    adc_set_clkdiv(0.0f); // Velocidade máxima: 500 mil amostras/s
+
+    sampler.dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config config = dma_channel_get_default_config(sampler.dma_channel);
+    channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+    channel_config_set_read_increment(&config, false);
+    channel_config_set_write_increment(&config, true);
+    channel_config_set_ring(&config, true, ADC_SAMPLER_RAW_LOG2);
+    channel_config_set_dreq(&config, DREQ_ADC);
+    channel_config_set_sniff_enable(&config, true);
+    dma_channel_configure(sampler.dma_channel, &config, raw_ring, &adc_hw->fifo,
+                          1u << oversample_log2, false);
+
+    irq_set_exclusive_handler(DMA_IRQ_1, adc_sampler_dma_handler);
+    dma_channel_set_irq1_enabled(sampler.dma_channel, true);
+    irq_set_enabled(DMA_IRQ_1, true);
+}
+
+void __not_in_flash_func(adc_sampler_burst)(uint input, uint oversample_log2,
+                                            adc_sampler_burst_callback_t callback, void *context)
+{
+    if (oversample_log2 > ADC_SAMPLER_MAX_OVERSAMPLE_LOG2)
+        oversample_log2 = ADC_SAMPLER_MAX_OVERSAMPLE_LOG2;
+
+    uint32_t irq = spin_lock_blocking(sampler.lock);
+    adc_run(false);
+    sampler.input = input;
+    sampler.oversample_log2 = oversample_log2;
+    sampler.callback = callback;
+    sampler.context = context;
+    adc_select_input(input);
+    // Descarta sobras da rajada anterior (conversões após o fim do DMA)
+    adc_fifo_drain();
+
+    dma_sniffer_enable(sampler.dma_channel, DMA_SNIFF_CTRL_CALC_VALUE_SUM, true);
+    dma_sniffer_set_data_accumulator(0);
+    dma_channel_set_trans_count(sampler.dma_channel, 1u << oversample_log2, true);
+    adc_run(true);
+    spin_unlock(sampler.lock, irq);
+}
+
+// Leitura avulsa entre rajadas, com o FIFO desligado para não misturar a
+// conversão com as amostras de uma rajada; a entrada da rajada volta em seguida
+uint16_t adc_sampler_read_aux(uint input)
+{
+    // Não interrompe uma rajada em andamento (ela dura poucos ms no máximo);
+    // a trava impede que outra comece enquanto a entrada está trocada
+    uint32_t irq;
+    while (true)
+    {
+        irq = spin_lock_blocking(sampler.lock);
+        if (!sampler.callback)
+            break;
+        spin_unlock(sampler.lock, irq);
+    }
+    // A rajada anterior pode ter deixado uma conversão em curso
+    while (!(adc_hw->cs & ADC_CS_READY_BITS))
+        tight_loop_contents();
+    hw_clear_bits(&adc_hw->fcs, ADC_FCS_EN_BITS);
+
+    adc_select_input(input);
+    uint16_t value = adc_read();
+    adc_select_input(sampler.input);
+
+    hw_set_bits(&adc_hw->fcs, ADC_FCS_EN_BITS);
+    spin_unlock(sampler.lock, irq);
+    return value;
+}
@@ -0,0 +1,28 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "pico/stdlib.h"
+
+// Leituras do ADC com sobreamostragem por DMA, em rajadas.
+//
+// Cada rajada (adc_sampler_burst) converte exatamente 2^oversample_log2
+// amostras de uma entrada na velocidade máxima do ADC, em modo FIFO; o DMA
+// transfere as amostras brutas para um anel em RAM e o sniffer do DMA as soma
+// sem intervenção da CPU. No fim a IRQ do DMA (DMA_IRQ_1) calcula a média
+// (filtro boxcar com decimação) e a entrega a um callback, usado pela
+// varredura de vários canais. Entre rajadas o ADC fica parado.
+
+#define ADC_SAMPLER_FRAC_BITS 4     // Leituras em contagens do ADC no formato Q12.4
+#define ADC_SAMPLER_RAW_LOG2 7      // Anel de amostras brutas: 2^7 bytes (64 amostras)
+#define ADC_SAMPLER_MAX_OVERSAMPLE_LOG2 16
+
+void adc_sampler_init(uint input, uint oversample_log2);
+
+// Rajada única em `input`; o callback roda no contexto da IRQ do DMA
+typedef void (*adc_sampler_burst_callback_t)(uint16_t value, void *context);
+void adc_sampler_burst(uint input, uint oversample_log2, adc_sampler_burst_callback_t callback, void *context);
+
+// Conversão avulsa em outra entrada sem misturar amostras no FIFO
+uint16_t adc_sampler_read_aux(uint input);
+
+#endif // ADC_SAMPLER_H
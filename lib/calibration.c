@@ -0,0 +1,95 @@
+#include "calibration.h"
+#include "crc.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include <stddef.h>
+#include <string.h>
+
+#define CALIBRATION_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define CALIBRATION_FLASH_TIMEOUT_MS 100
+
+typedef struct
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t count;
+    temp_calibration_point_t points[TEMP_CALIBRATION_MAX_POINTS];
+    uint32_t crc;
+} calibration_record_t;
+
+// Registro em RAM; a gravação programa uma página inteira a partir dele
+static union
+{
+    calibration_record_t record;
+    uint8_t page[FLASH_PAGE_SIZE];
+} calibration;
+
+static uint32_t calibration_record_crc(const calibration_record_t *record)
+{
+    return crc32(record, offsetof(calibration_record_t, crc));
+}
+
+static void calibration_apply(void)
+{
+    temperature_set_calibration(calibration.record.points, calibration.record.count);
+}
+
+// Roda com o outro núcleo parado e as interrupções desligadas
+static void calibration_flash_write(void *param)
+{
+    flash_range_erase(CALIBRATION_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+    flash_range_program(CALIBRATION_FLASH_OFFSET, calibration.page, FLASH_PAGE_SIZE);
+}
+
+static bool calibration_save(void)
+{
+    calibration.record.magic = CALIBRATION_MAGIC;
+    calibration.record.version = CALIBRATION_VERSION;
+    calibration.record.crc = calibration_record_crc(&calibration.record);
+    return flash_safe_execute(calibration_flash_write, NULL, CALIBRATION_FLASH_TIMEOUT_MS) == PICO_OK;
+}
+
+bool calibration_load(void)
+{
+    const calibration_record_t *stored =
+        (const calibration_record_t *)(XIP_BASE + CALIBRATION_FLASH_OFFSET);
+
+    memset(&calibration, 0, sizeof(calibration));
+    bool valid = stored->magic == CALIBRATION_MAGIC && stored->version == CALIBRATION_VERSION &&
+                 stored->count <= TEMP_CALIBRATION_MAX_POINTS &&
+                 stored->crc == calibration_record_crc(stored);
+    if (valid)
+        calibration.record = *stored;
+    calibration_apply();
+    return valid;
+}
+
+bool calibration_add_point(temp_centi_t measured, temp_centi_t reference)
+{
+    calibration_record_t *record = &calibration.record;
+    uint index = 0;
+    while (index < record->count && record->points[index].measured != measured)
+        index++;
+    if (index == TEMP_CALIBRATION_MAX_POINTS)
+        return false;
+
+    record->points[index].measured = measured;
+    record->points[index].reference = reference;
+    if (index == record->count)
+        record->count++;
+    calibration_apply();
+    return calibration_save();
+}
+
+bool calibration_clear(void)
+{
+    calibration.record.count = 0;
+    calibration_apply();
+    return calibration_save();
+}
+
+uint calibration_points(const temp_calibration_point_t **points)
+{
+    *points = calibration.record.points;
+    return calibration.record.count;
+}
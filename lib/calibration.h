@@ -0,0 +1,30 @@
+#ifndef CALIBRATION_H
+#define CALIBRATION_H
+
+#include "pico/stdlib.h"
+#include "temperature.h"
+
+// Calibração de campo do sensor guardada no último setor da flash.
+//
+// Cada ponto associa a leitura do modelo do sensor à temperatura medida por
+// um termômetro de referência no mesmo instante. Os pontos são aplicados pela
+// lib/temperature como correção linear por partes; a gravação usa
+// flash_safe_execute, então o núcleo 1 precisa ter chamado
+// flash_safe_execute_core_init() antes.
+
+#define CALIBRATION_MAGIC 0x4C414354u // "TCAL"
+#define CALIBRATION_VERSION 1
+
+// Lê a calibração da flash e aplica; falso se não houver registro válido
+bool calibration_load(void);
+
+// Acrescenta (ou substitui, para a mesma leitura) um ponto, aplica e grava
+bool calibration_add_point(temp_centi_t measured, temp_centi_t reference);
+
+// Remove todos os pontos e grava
+bool calibration_clear(void);
+
+// Pontos em uso, ordenados como foram registrados
+uint calibration_points(const temp_calibration_point_t **points);
+
+#endif // CALIBRATION_H
@@ -0,0 +1,44 @@
+#include "crc.h"
+
+uint32_t crc32(const void *data, size_t length)
+{
+    const uint8_t *bytes = data;
+    uint32_t crc = 0xFFFFFFFFu;
+    while (length--)
+    {
+        crc ^= *bytes++;
+        for (unsigned bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
+
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t length)
+{
+    const uint8_t *bytes = data;
+    while (length--)
+    {
+        crc ^= (uint16_t)*bytes++ << 8;
+        for (unsigned bit = 0; bit < 8; bit++)
+            crc = (crc << 1) ^ (0x1021 & -(crc >> 15));
+    }
+    return crc;
+}
+
+uint16_t crc16_ccitt(const void *data, size_t length)
+{
+    return crc16_ccitt_update(CRC16_CCITT_INIT, data, length);
+}
+
+uint16_t crc16_modbus(const void *data, size_t length)
+{
+    const uint8_t *bytes = data;
+    uint16_t crc = 0xFFFF;
+    while (length--)
+    {
+        crc ^= *bytes++;
+        for (unsigned bit = 0; bit < 8; bit++)
+            crc = (crc >> 1) ^ (0xA001 & -(crc & 1));
+    }
+    return crc;
+}
@@ -0,0 +1,22 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// CRCs bit a bit, sem tabela: usados em registros curtos (flash, quadros)
+
+// CRC-32 (polinômio refletido 0xEDB88320, o do zlib), dos registros na flash
+uint32_t crc32(const void *data, size_t length);
+
+// CRC-16/CCITT-FALSE (polinômio 0x1021, início 0xFFFF), dos quadros enviados
+// pela USB. _update continua um CRC já começado, para dados em partes
+#define CRC16_CCITT_INIT 0xFFFF
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, size_t length);
+uint16_t crc16_ccitt(const void *data, size_t length);
+
+// CRC-16/MODBUS (polinômio refletido 0xA001, início 0xFFFF), dos quadros
+// Modbus RTU; vai no quadro com o byte menos significativo primeiro
+uint16_t crc16_modbus(const void *data, size_t length);
+
+#endif // CRC_H
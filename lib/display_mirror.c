@@ -0,0 +1,121 @@
+#include "display_mirror.h"
+#include <string.h>
+
+#define SPAN_BYTES (DISPLAY_MIRROR_SPAN * DISPLAY_MIRROR_PAGES)
+#define SPAN_MAX_ENCODED (2 + SPAN_BYTES + SPAN_BYTES / 128 + 1)
+
+void display_mirror_reset(display_mirror_t *mirror)
+{
+    memset(mirror->shadow, 0, sizeof(mirror->shadow));
+    mirror->cursor = 0;
+    mirror->key = true;
+}
+
+static bool column_changed(const display_mirror_t *mirror, const uint8_t *frame, uint8_t x)
+{
+    return memcmp(&mirror->shadow[x * DISPLAY_MIRROR_PAGES], &frame[x * DISPLAY_MIRROR_PAGES],
+                  DISPLAY_MIRROR_PAGES) != 0;
+}
+
+// PackBits: repetições de 2 ou mais bytes, literais até 128 bytes que só
+// param diante de uma repetição de 3
+static uint16_t packbits(const uint8_t *in, uint16_t count, uint8_t *out)
+{
+    uint16_t i = 0, length = 0;
+    while (i < count)
+    {
+        uint16_t run = 1;
+        while (i + run < count && run < 128 && in[i + run] == in[i])
+            run++;
+        if (run >= 2)
+        {
+            out[length++] = (uint8_t)(257 - run);
+            out[length++] = in[i];
+            i += run;
+            continue;
+        }
+
+        uint16_t start = i;
+        while (i < count && i - start < 128)
+        {
+            if (i + 2 < count && in[i] == in[i + 1] && in[i] == in[i + 2])
+                break;
+            i++;
+        }
+        out[length++] = (uint8_t)(i - start - 1);
+        memcpy(&out[length], &in[start], i - start);
+        length += i - start;
+    }
+    return length;
+}
+
+// Codifica um trecho em `out`; falso (e nada muda) se não couber em `room`
+static bool encode_span(display_mirror_t *mirror, const uint8_t *frame, uint8_t x0, uint8_t columns,
+                        uint8_t *out, uint16_t *length, uint16_t room)
+{
+    uint8_t delta[SPAN_BYTES];
+    uint8_t encoded[SPAN_MAX_ENCODED];
+    uint16_t offset = x0 * DISPLAY_MIRROR_PAGES;
+    uint16_t bytes = columns * DISPLAY_MIRROR_PAGES;
+    for (uint16_t i = 0; i < bytes; i++)
+    {
+        delta[i] = frame[offset + i] ^ mirror->shadow[offset + i];
+    }
+
+    encoded[0] = x0;
+    encoded[1] = columns;
+    uint16_t size = 2 + packbits(delta, bytes, &encoded[2]);
+    if (*length + size > room)
+        return false;
+
+    memcpy(&out[*length], encoded, size);
+    *length += size;
+    memcpy(&mirror->shadow[offset], &frame[offset], bytes);
+    return true;
+}
+
+uint16_t display_mirror_encode(display_mirror_t *mirror, const uint8_t *frame, uint8_t *out,
+                               uint16_t size, bool *synced)
+{
+    uint16_t length = sizeof(display_mirror_header_t);
+    uint8_t span_x0 = 0, span_columns = 0;
+    *synced = true;
+
+    // Começa na coluna onde o quadro anterior parou: uma região que muda a
+    // todo quadro não impede o resto da tela de chegar
+    for (uint16_t i = 0; i <= DISPLAY_MIRROR_COLUMNS; i++)
+    {
+        uint8_t x = (mirror->cursor + i) % DISPLAY_MIRROR_COLUMNS;
+        bool changed = i < DISPLAY_MIRROR_COLUMNS && column_changed(mirror, frame, x);
+        if (changed && span_columns && x == span_x0 + span_columns && span_columns < DISPLAY_MIRROR_SPAN)
+        {
+            span_columns++;
+            continue;
+        }
+        if (span_columns)
+        {
+            if (!encode_span(mirror, frame, span_x0, span_columns, out, &length, size))
+            {
+                mirror->cursor = span_x0;
+                *synced = false;
+                break;
+            }
+            span_columns = 0;
+        }
+        if (changed)
+        {
+            span_x0 = x;
+            span_columns = 1;
+        }
+    }
+
+    if (length == sizeof(display_mirror_header_t) && !mirror->key)
+        return 0;
+
+    display_mirror_header_t header = {
+        .sequence = mirror->sequence++,
+        .flags = (mirror->key ? DISPLAY_MIRROR_KEY : 0) | (*synced ? DISPLAY_MIRROR_SYNCED : 0)};
+    memcpy(out, &header, sizeof(header));
+    mirror->key = false;
+    return length;
+}
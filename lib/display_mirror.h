@@ -0,0 +1,57 @@
+#ifndef DISPLAY_MIRROR_H
+#define DISPLAY_MIRROR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Espelho do display no host: codifica só as colunas que mudaram desde o
+// último quadro espelhado.
+//
+// A imagem é a do ram_buffer do ssd1306 (sem o byte de controle): coluna a
+// coluna, 8 bytes por coluna, um por página de 8 linhas. Cada quadro é
+//
+//   display_mirror_header_t | trecho | trecho | ...
+//
+// e cada trecho cobre até DISPLAY_MIRROR_SPAN colunas seguidas:
+//
+//   primeira coluna (1) | colunas (1) | colunas * 8 bytes em PackBits
+//
+// Os bytes são o XOR da coluna nova com a já espelhada, de modo que pixels
+// iguais viram zeros e o PackBits os junta em repetições (n de 0 a 127: n + 1
+// bytes literais; n de 129 a 255: o byte seguinte 257 - n vezes). O host
+// aplica o XOR sobre a própria cópia. Um quadro que não cabe fica para o
+// próximo, continuando de onde parou; DISPLAY_MIRROR_SYNCED marca o que fecha
+// a imagem. Um quadro perdido desalinha o host até o próximo quadro-chave,
+// que ele pede religando o espelho.
+
+#define DISPLAY_MIRROR_COLUMNS 128
+#define DISPLAY_MIRROR_PAGES 8
+#define DISPLAY_MIRROR_SPAN 16 // Colunas por trecho: 128 bytes, 131 no pior caso
+
+#define DISPLAY_MIRROR_KEY 0x01    // O host parte da imagem apagada
+#define DISPLAY_MIRROR_SYNCED 0x02 // Depois deste quadro o host tem a imagem inteira
+
+typedef struct __attribute__((packed))
+{
+    uint16_t sequence; // Quadros do espelho, para o host notar perdas
+    uint8_t flags;
+} display_mirror_header_t;
+
+typedef struct
+{
+    uint8_t shadow[DISPLAY_MIRROR_COLUMNS * DISPLAY_MIRROR_PAGES]; // Imagem que o host tem
+    uint16_t sequence;
+    uint8_t cursor; // Coluna onde o próximo quadro começa
+    bool key;
+} display_mirror_t;
+
+// Recomeça com um quadro-chave (o host apaga a imagem e recebe tudo)
+void display_mirror_reset(display_mirror_t *mirror);
+
+// Codifica em `out` as colunas de `frame` diferentes da cópia do host, até
+// `size` bytes; devolve o tamanho do quadro ou 0 se nada mudou. `synced` diz
+// se todas as mudanças couberam.
+uint16_t display_mirror_encode(display_mirror_t *mirror, const uint8_t *frame, uint8_t *out,
+                               uint16_t size, bool *synced);
+
+#endif // DISPLAY_MIRROR_H
@@ -0,0 +1,43 @@
+#include "events.h"
+#include "hardware/sync.h"
+
+static spin_lock_t *lock;
+static volatile uint32_t pending;
+
+void events_init(void)
+{
+    if (!lock)
+        lock = spin_lock_init(spin_lock_claim_unused(true));
+    pending = 0;
+}
+
+void events_post(uint32_t events)
+{
+    // Trava de hardware: os dois núcleos podem marcar ao mesmo tempo
+    uint32_t irq = spin_lock_blocking(lock);
+    pending |= events;
+    spin_unlock(lock, irq);
+    __sev();
+}
+
+static uint32_t events_take(void)
+{
+    uint32_t irq = spin_lock_blocking(lock);
+    uint32_t events = pending;
+    pending = 0;
+    spin_unlock(lock, irq);
+    return events;
+}
+
+uint32_t events_wait(absolute_time_t deadline)
+{
+    while (true)
+    {
+        uint32_t events = events_take();
+        if (events)
+            return events;
+        // Acorda com SEV, com qualquer IRQ deste núcleo ou no prazo
+        if (best_effort_wfe_or_timeout(deadline))
+            return events_take();
+    }
+}
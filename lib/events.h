@@ -0,0 +1,23 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "pico/stdlib.h"
+
+// Eventos para o laço principal do núcleo 0.
+//
+// IRQs de qualquer núcleo marcam bits com events_post(); o laço dorme em
+// events_wait() com WFE até algum bit ser marcado ou o prazo vencer, e
+// recebe todos os pendentes de uma vez. O SEV de events_post() acorda o
+// núcleo mesmo quando o bit chega entre a verificação e o WFE. Os bits são
+// definidos por quem usa.
+
+void events_init(void);
+
+// Marca eventos; pode ser chamada de IRQ ou do outro núcleo
+void events_post(uint32_t events);
+
+// Dorme até haver eventos ou até `deadline` (at_the_end_of_time para não ter
+// prazo); devolve e limpa os pendentes, 0 se o prazo venceu sem eventos
+uint32_t events_wait(absolute_time_t deadline);
+
+#endif // EVENTS_H
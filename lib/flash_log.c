@@ -0,0 +1,248 @@
+#include "flash_log.h"
+#include "crc.h"
+#include "pico/flash.h"
+#include <string.h>
+
+// Região logo abaixo do setor da calibração (último da flash)
+#define FLASH_LOG_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE - FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
+#define FLASH_LOG_TIMEOUT_MS 100
+
+extern char __flash_binary_end; // Fim da imagem do programa (linker)
+
+static bool available = false;
+static uint8_t record_fields;
+static uint32_t head_page;   // Próxima página a gravar
+static uint32_t next_sequence;
+static uint32_t next_record; // Número do próximo registro a entrar na página
+
+// Registros por página efetivamente obtidos pelo codec
+static uint32_t measured_records;
+static uint32_t measured_pages;
+
+// Página em formação; a gravação programa uma página inteira a partir dela
+static union
+{
+    flash_log_page_header_t header;
+    uint8_t bytes[FLASH_PAGE_SIZE];
+} page;
+
+static series_encoder_t encoder;
+
+static inline uint32_t page_offset(uint32_t index)
+{
+    return FLASH_LOG_OFFSET + index * FLASH_PAGE_SIZE;
+}
+
+static inline const uint8_t *page_at(uint32_t index)
+{
+    return (const uint8_t *)(XIP_BASE + page_offset(index));
+}
+
+static inline uint32_t page_crc(const uint8_t *bytes)
+{
+    return crc32(bytes + sizeof(uint32_t), FLASH_PAGE_SIZE - sizeof(uint32_t));
+}
+
+static const flash_log_page_header_t *page_valid(uint32_t index)
+{
+    const flash_log_page_header_t *header = (const flash_log_page_header_t *)page_at(index);
+    if (header->magic != FLASH_LOG_MAGIC || header->version != FLASH_LOG_VERSION ||
+        header->crc != page_crc(page_at(index)))
+        return NULL;
+    return header;
+}
+
+static bool page_erased(uint32_t index)
+{
+    const uint32_t *words = (const uint32_t *)page_at(index);
+    for (uint i = 0; i < FLASH_PAGE_SIZE / sizeof(uint32_t); i++)
+    {
+        if (words[i] != 0xFFFFFFFFu)
+            return false;
+    }
+    return true;
+}
+
+static void page_reset(void)
+{
+    memset(page.bytes, 0xFF, sizeof(page.bytes));
+    series_encoder_init(&encoder, page.bytes + sizeof(flash_log_page_header_t),
+                        FLASH_LOG_PAGE_PAYLOAD, record_fields);
+}
+
+// Apaga o setor ao entrar nele e programa a página. Nada aqui lê a flash.
+static void __not_in_flash_func(flash_log_flash_write)(void *param)
+{
+    uint32_t offset = page_offset(head_page);
+    if (head_page % FLASH_LOG_PAGES_PER_SECTOR == 0)
+        flash_range_erase(offset, FLASH_SECTOR_SIZE);
+    flash_range_program(offset, page.bytes, FLASH_PAGE_SIZE);
+}
+
+static bool flash_log_write_page(void)
+{
+    page.header.magic = FLASH_LOG_MAGIC;
+    page.header.version = FLASH_LOG_VERSION;
+    page.header.sequence = next_sequence;
+    page.header.count = encoder.count;
+    page.header.first_record = next_record - encoder.count;
+    page.header.fields = record_fields;
+    page.header.crc = page_crc(page.bytes);
+
+#if PICO_COPY_TO_RAM
+    // Programa inteiro na RAM: o outro núcleo e as IRQs deste seguem rodando
+    flash_log_flash_write(NULL);
+    bool written = true;
+#else
+    bool written = flash_safe_execute(flash_log_flash_write, NULL, FLASH_LOG_TIMEOUT_MS) == PICO_OK;
+#endif
+
+    // Com falha os registros da página se perdem e a mesma posição é
+    // tentada de novo (com novo apagamento, se for início de setor)
+    if (written)
+    {
+        head_page = (head_page + 1) % FLASH_LOG_PAGES;
+        next_sequence++;
+        measured_records += encoder.count;
+        measured_pages++;
+    }
+    page_reset();
+    return written;
+}
+
+bool flash_log_init(uint8_t fields)
+{
+    available = false;
+    if (fields == 0 || fields > SERIES_CODEC_MAX_FIELDS ||
+        (uintptr_t)&__flash_binary_end - XIP_BASE > FLASH_LOG_OFFSET)
+        return false;
+
+    record_fields = fields;
+    head_page = 0;
+    next_sequence = 0;
+    next_record = 0;
+    measured_records = 0;
+    measured_pages = 0;
+    page_reset();
+    available = true;
+
+    // Setor mais novo: o de maior sequência na primeira página
+    const flash_log_page_header_t *newest = NULL;
+    uint32_t newest_sector = 0;
+    for (uint32_t sector = 0; sector < FLASH_LOG_SECTORS; sector++)
+    {
+        const flash_log_page_header_t *header = page_valid(sector * FLASH_LOG_PAGES_PER_SECTOR);
+        if (header && (!newest || (int32_t)(header->sequence - newest->sequence) > 0))
+        {
+            newest = header;
+            newest_sector = sector;
+        }
+    }
+    if (!newest)
+        return true; // Arquivo vazio: começa no setor 0
+
+    // Última página válida do setor e a primeira apagada depois dela
+    uint32_t first = newest_sector * FLASH_LOG_PAGES_PER_SECTOR;
+    uint32_t free_page = first + FLASH_LOG_PAGES_PER_SECTOR;
+    for (uint32_t index = first; index < first + FLASH_LOG_PAGES_PER_SECTOR; index++)
+    {
+        const flash_log_page_header_t *header = page_valid(index);
+        if (header && (int32_t)(header->sequence - newest->sequence) >= 0)
+        {
+            newest = header;
+            free_page = first + FLASH_LOG_PAGES_PER_SECTOR;
+        }
+        else if (free_page == first + FLASH_LOG_PAGES_PER_SECTOR && page_erased(index))
+        {
+            free_page = index;
+        }
+    }
+
+    // Setor cheio: a próxima gravação apaga o seguinte (o mais antigo)
+    head_page = free_page % FLASH_LOG_PAGES;
+    next_sequence = newest->sequence + 1;
+    next_record = newest->first_record + newest->count;
+    if (newest->fields == fields)
+    {
+        measured_records = newest->count;
+        measured_pages = 1;
+    }
+    return true;
+}
+
+bool flash_log_append(const int16_t *record)
+{
+    if (!available)
+        return false;
+
+    bool written = true;
+    if (!series_encoder_add(&encoder, record))
+    {
+        // Página cheia: grava e começa um bloco novo (o primeiro sempre cabe)
+        written = flash_log_write_page();
+        series_encoder_add(&encoder, record);
+    }
+    next_record++;
+    return written;
+}
+
+uint32_t flash_log_records(void)
+{
+    return next_record - encoder.count;
+}
+
+void flash_log_info(uint32_t records_per_day, flash_log_info_t *out)
+{
+    memset(out, 0, sizeof(*out));
+    if (!available || records_per_day == 0)
+        return;
+
+    // Pior caso do codec: 4 + 17 bits por campo
+    uint32_t record_bits = record_fields * (4 + 17);
+    out->records_per_page_raw = FLASH_LOG_PAGE_PAYLOAD / (record_fields * sizeof(int16_t));
+    out->records_per_page = measured_pages ? measured_records / measured_pages
+                                           : FLASH_LOG_PAGE_PAYLOAD * 8 / record_bits;
+    if (out->records_per_page == 0)
+        out->records_per_page = 1;
+    uint32_t records_per_page = out->records_per_page;
+    out->pages_per_day = (records_per_day + records_per_page - 1) / records_per_page;
+    out->bytes_per_day = out->pages_per_day * FLASH_PAGE_SIZE;
+    // O setor que está sendo reaproveitado não conta: ele é apagado inteiro
+    uint32_t retained_pages = (FLASH_LOG_SECTORS - 1) * FLASH_LOG_PAGES_PER_SECTOR;
+    out->retention_days = retained_pages / out->pages_per_day;
+    // Cada volta do anel apaga cada setor uma vez
+    uint64_t pages_lifetime = (uint64_t)FLASH_LOG_PAGES * FLASH_LOG_ERASE_CYCLES;
+    out->lifetime_years = pages_lifetime / out->pages_per_day / 365;
+}
+
+void flash_log_cursor_init(flash_log_cursor_t *cursor)
+{
+    // O mais antigo está no setor seguinte ao da cabeça, ou no próprio setor
+    // da cabeça se ela está no início dele (ainda não apagado)
+    uint32_t sector = head_page / FLASH_LOG_PAGES_PER_SECTOR;
+    if (head_page % FLASH_LOG_PAGES_PER_SECTOR)
+        sector = (sector + 1) % FLASH_LOG_SECTORS;
+    cursor->page = sector * FLASH_LOG_PAGES_PER_SECTOR;
+    cursor->visited = 0;
+}
+
+void flash_log_page_decoder(const flash_log_page_header_t *header, series_decoder_t *decoder)
+{
+    series_decoder_init(decoder, (const uint8_t *)(header + 1), header->fields, header->count);
+}
+
+const flash_log_page_header_t *flash_log_next(flash_log_cursor_t *cursor)
+{
+    while (available && cursor->visited < FLASH_LOG_PAGES)
+    {
+        uint32_t index = cursor->page;
+        cursor->page = (cursor->page + 1) % FLASH_LOG_PAGES;
+        cursor->visited++;
+        const flash_log_page_header_t *header = page_valid(index);
+        // Restos de um arquivo antigo na mesma região ficam de fora pela sequência
+        if (header && (int32_t)(next_sequence - header->sequence) > 0 &&
+            next_sequence - header->sequence <= FLASH_LOG_PAGES)
+            return header;
+    }
+    return NULL;
+}
@@ -0,0 +1,93 @@
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+#include "series_codec.h"
+
+// Arquivo de registros na flash, só de acréscimo.
+//
+// A região fica logo abaixo do setor da calibração e é usada como anel de
+// setores. Os registros (campos int16 a intervalo fixo) são comprimidos com
+// lib/series_codec em uma página na RAM e gravados uma página por vez, cada
+// uma com cabeçalho, número de sequência e CRC-32. Cada página começa um bloco
+// do codec e pode ser lida sozinha.
+//
+// Um setor só é apagado quando a escrita chega à sua primeira página, sempre
+// o mais antigo: os apagamentos se repetem em rodízio por todos os setores,
+// que se desgastam por igual.
+//
+// No boot, flash_log_init() encontra a cabeça lendo a primeira página de
+// cada setor e depois as páginas do setor mais novo, ou seja, no máximo
+// FLASH_LOG_SECTORS + FLASH_LOG_PAGES_PER_SECTOR páginas, qualquer que seja o
+// conteúdo. Páginas com CRC inválido (gravação interrompida) são ignoradas.
+//
+// Com o binário copy_to_ram nenhum código roda da flash, então o apagamento
+// (dezenas de ms) prende só o núcleo que grava e a aquisição no outro núcleo
+// segue normalmente. Fora desse modo a gravação cai em flash_safe_execute,
+// que pausa o outro núcleo.
+
+#define FLASH_LOG_MAGIC 0x474F4C54u // "TLOG"
+#define FLASH_LOG_VERSION 2
+
+#ifndef FLASH_LOG_SECTORS
+#define FLASH_LOG_SECTORS 256 // 1 MB
+#endif
+#define FLASH_LOG_PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define FLASH_LOG_PAGES (FLASH_LOG_SECTORS * FLASH_LOG_PAGES_PER_SECTOR)
+#define FLASH_LOG_ERASE_CYCLES 100000 // Resistência típica de um setor
+
+typedef struct
+{
+    uint32_t crc;          // CRC-32 do restante da página
+    uint32_t magic;
+    uint32_t sequence;     // Número da página, contínuo entre resets
+    uint32_t first_record; // Número do primeiro registro da página
+    uint16_t count;
+    uint8_t fields; // Campos int16 por registro
+    uint8_t version;
+} flash_log_page_header_t;
+
+#define FLASH_LOG_PAGE_PAYLOAD (FLASH_PAGE_SIZE - sizeof(flash_log_page_header_t))
+
+// Capacidade e desgaste para uma taxa de registros. Registros por página é a
+// média medida nas páginas gravadas (sem medida, o pior caso do codec)
+typedef struct
+{
+    uint16_t records_per_page;
+    uint16_t records_per_page_raw; // Sem compressão, para comparação
+    uint32_t pages_per_day;
+    uint32_t bytes_per_day;       // Gravados na flash, com cabeçalhos e sobras
+    uint32_t retention_days;      // Histórico recuperável com o anel cheio
+    uint32_t lifetime_years;      // Até FLASH_LOG_ERASE_CYCLES por setor
+} flash_log_info_t;
+
+// Percorre as páginas válidas da mais antiga para a mais nova
+typedef struct
+{
+    uint32_t page;
+    uint32_t visited;
+} flash_log_cursor_t;
+
+// Encontra a cabeça do arquivo para registros de `fields` campos int16;
+// falso se a região não está disponível (sobreposta ao programa)
+bool flash_log_init(uint8_t fields);
+
+// Acrescenta um registro; grava a página quando o próximo não cabe mais.
+// Falso se a gravação falhar (os registros da página se perdem)
+bool flash_log_append(const int16_t *record);
+
+// Registros já gravados na flash desde o primeiro boot com o arquivo
+uint32_t flash_log_records(void);
+
+void flash_log_info(uint32_t records_per_day, flash_log_info_t *out);
+
+void flash_log_cursor_init(flash_log_cursor_t *cursor);
+
+// Próxima página válida (via XIP) ou NULL no fim
+const flash_log_page_header_t *flash_log_next(flash_log_cursor_t *cursor);
+
+// Prepara a leitura, registro a registro, de uma página devolvida acima
+void flash_log_page_decoder(const flash_log_page_header_t *header, series_decoder_t *decoder);
+
+#endif // FLASH_LOG_H
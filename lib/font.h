@@ -1,6 +1,6 @@
 // Fontes para A-Z e 0-9. Os caracteres tem 8x8 pixels
 
-static uint8_t font[] = {
+static const uint8_t font[] = {
     0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // Nothing
     0x3e, 0x41, 0x41, 0x49, 0x41, 0x41, 0x3e, 0x00, // 0
     0x00, 0x00, 0x42, 0x7f, 0x40, 0x00, 0x00, 0x00, // 1
@@ -101,4 +101,17 @@ static uint8_t font[] = {
     0x02, 0x01, 0x51, 0x09, 0x06, 0x00, 0x00, 0x00, // ?
     0x3e, 0x41, 0x5d, 0x55, 0x1e, 0x00, 0x00, 0x00, // @
 
-};
\ No newline at end of file
+};
+
+// Índice do glifo em font[] para cada código ASCII (0 = glifo vazio).
+// Substitui a cadeia de comparações por uma única leitura em flash.
+static const uint8_t font_glyph_index[128] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  // 0x00-0x0F
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  // 0x10-0x1F
+     0, 63, 64, 65, 66, 67, 68, 69, 70, 71, 72, 73, 74, 75, 76, 77,  // 0x20-0x2F
+     1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 88, 89, 90, 91, 92, 93,  // 0x30-0x3F
+    94, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,  // 0x40-0x4F
+    26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36,  0,  0,  0,  0,  0,  // 0x50-0x5F
+     0, 37, 38, 39, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51,  // 0x60-0x6F
+    52, 53, 54, 55, 56, 57, 58, 59, 60, 61, 62,  0,  0,  0,  0,  0,  // 0x70-0x7F
+};
@@ -0,0 +1,123 @@
+#include "frame.h"
+#include "crc.h"
+#include <string.h>
+
+// Codificador COBS incremental: cada bloco começa com a distância até o
+// próximo 0 (ou 0xFF para um bloco cheio, sem 0 implícito)
+typedef struct
+{
+    uint8_t *out;
+    size_t code_index;
+    size_t length;
+    uint8_t code;
+} cobs_writer_t;
+
+static void cobs_begin(cobs_writer_t *writer, uint8_t *out)
+{
+    writer->out = out;
+    writer->code_index = 0;
+    writer->length = 1;
+    writer->code = 1;
+}
+
+static void cobs_put(cobs_writer_t *writer, uint8_t byte)
+{
+    if (byte != 0)
+    {
+        writer->out[writer->length++] = byte;
+        writer->code++;
+    }
+    if (byte == 0 || writer->code == 0xFF)
+    {
+        writer->out[writer->code_index] = writer->code;
+        writer->code_index = writer->length++;
+        writer->code = 1;
+    }
+}
+
+static void cobs_put_bytes(cobs_writer_t *writer, const uint8_t *bytes, size_t length)
+{
+    while (length--)
+        cobs_put(writer, *bytes++);
+}
+
+size_t frame_encode(uint8_t type, const void *payload, uint16_t length, uint8_t *out)
+{
+    uint8_t header[3] = {type, length & 0xFF, length >> 8};
+
+    uint16_t crc = crc16_ccitt_update(CRC16_CCITT_INIT, header, sizeof(header));
+    crc = crc16_ccitt_update(crc, payload, length);
+    uint8_t trailer[2] = {crc & 0xFF, crc >> 8};
+
+    cobs_writer_t writer;
+    cobs_begin(&writer, out);
+    cobs_put_bytes(&writer, header, sizeof(header));
+    cobs_put_bytes(&writer, payload, length);
+    cobs_put_bytes(&writer, trailer, sizeof(trailer));
+    writer.out[writer.code_index] = writer.code;
+    writer.out[writer.length++] = 0;
+    return writer.length;
+}
+
+void frame_decoder_init(frame_decoder_t *decoder, uint8_t *buffer, uint16_t size)
+{
+    memset(decoder, 0, sizeof(*decoder));
+    decoder->buffer = buffer;
+    decoder->size = size;
+}
+
+// Decodifica o COBS no próprio buffer; devolve o tamanho ou -1 se inválido
+static int cobs_decode_in_place(uint8_t *buffer, uint16_t length)
+{
+    uint16_t read = 0, write = 0;
+    while (read < length)
+    {
+        uint8_t code = buffer[read++];
+        if (code == 0 || read + code - 1 > length)
+            return -1;
+        for (uint8_t i = 1; i < code; i++)
+            buffer[write++] = buffer[read++];
+        if (code != 0xFF && read < length)
+            buffer[write++] = 0;
+    }
+    return write;
+}
+
+bool frame_decoder_feed(frame_decoder_t *decoder, uint8_t byte)
+{
+    if (byte != 0)
+    {
+        if (decoder->length < decoder->size)
+            decoder->buffer[decoder->length++] = byte;
+        else
+            decoder->overflow = true;
+        return false;
+    }
+
+    // Delimitador: fecha o quadro em curso
+    uint16_t received = decoder->length;
+    bool overflow = decoder->overflow;
+    decoder->length = 0;
+    decoder->overflow = false;
+    if (received == 0)
+        return false; // Zeros seguidos: nada a fazer
+
+    int decoded = overflow ? -1 : cobs_decode_in_place(decoder->buffer, received);
+    if (decoded < FRAME_OVERHEAD)
+    {
+        decoder->errors++;
+        return false;
+    }
+    const uint8_t *raw = decoder->buffer;
+    uint16_t length = raw[1] | (raw[2] << 8);
+    uint16_t crc = raw[decoded - 2] | (raw[decoded - 1] << 8);
+    if (length != decoded - FRAME_OVERHEAD || crc != crc16_ccitt(raw, decoded - 2))
+    {
+        decoder->errors++;
+        return false;
+    }
+    decoder->type = raw[0];
+    decoder->payload = raw + 3;
+    decoder->payload_length = length;
+    return true;
+}
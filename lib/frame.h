@@ -0,0 +1,48 @@
+#ifndef FRAME_H
+#define FRAME_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Quadros binários delimitados por COBS.
+//
+// Antes da codificação o quadro é
+//
+//   tipo (1) | tamanho do conteúdo (2, LE) | conteúdo | CRC-16 (2, LE)
+//
+// com o CRC-16/CCITT-FALSE sobre tipo, tamanho e conteúdo. O COBS tira todos
+// os bytes 0 e um 0 fecha o quadro: um receptor que perde bytes se
+// ressincroniza no próximo 0.
+
+#define FRAME_OVERHEAD 5 // Tipo, tamanho e CRC
+#define FRAME_MAX_PAYLOAD 320
+
+// Maior quadro codificado para `payload` bytes, com o delimitador
+#define FRAME_ENCODED_SIZE(payload) \
+    ((payload) + FRAME_OVERHEAD + ((payload) + FRAME_OVERHEAD) / 254 + 2)
+
+// Codifica um quadro em `out` (FRAME_ENCODED_SIZE(length) bytes); devolve o
+// tamanho gravado, delimitador incluído
+size_t frame_encode(uint8_t type, const void *payload, uint16_t length, uint8_t *out);
+
+// Recepção byte a byte
+typedef struct
+{
+    uint8_t *buffer;
+    uint16_t size;
+    uint16_t length;   // Bytes recebidos do quadro em curso
+    bool overflow;
+    uint8_t type;      // Quadro válido: tipo, conteúdo e tamanho
+    const uint8_t *payload;
+    uint16_t payload_length;
+    uint32_t errors;   // Quadros descartados (CRC, tamanho ou estouro)
+} frame_decoder_t;
+
+void frame_decoder_init(frame_decoder_t *decoder, uint8_t *buffer, uint16_t size);
+
+// Verdadeiro quando o byte fecha um quadro válido; o conteúdo fica em
+// decoder->payload até o próximo byte
+bool frame_decoder_feed(frame_decoder_t *decoder, uint8_t byte);
+
+#endif // FRAME_H
@@ -27,9 +27,9 @@ void draw_axis(ssd1306_t *ssd, const char *x_label, const char *y_label)
     
 }
 
-void draw_point(ssd1306_t *ssd, Graph *graph, float x, float y)
+void draw_point(ssd1306_t *ssd, Graph *graph, uint16_t x_q8, int16_t y)
 {
-    uint8_t screen_x = scale_x(graph, x);
+    uint8_t screen_x = scale_x(graph, x_q8);
     uint8_t screen_y = scale_y(graph, y);
 
     // Desenha um ponto 2x2 pixels
@@ -42,31 +42,34 @@ void draw_point(ssd1306_t *ssd, Graph *graph, float x, float y)
     }
 }
 
-void draw_line_graph(ssd1306_t *ssd, Graph *graph, float *values, uint8_t num_points)
+void draw_line_graph(ssd1306_t *ssd, Graph *graph, const int16_t *values, uint8_t num_points)
 {
     if (num_points < 2)
         return;
 
-    float x_step = (float)graph->width / (num_points - 1);
+    uint8_t last = num_points - 1;
 
     for (uint8_t i = 0; i < num_points - 1; i++)
     {
-        uint8_t x1 = graph->x_offset + (i * x_step);
+        uint8_t x1 = graph->x_offset + (i * graph->width) / last;
         uint8_t y1 = scale_y(graph, values[i]);
-        uint8_t x2 = graph->x_offset + ((i + 1) * x_step);
+        uint8_t x2 = graph->x_offset + ((i + 1) * graph->width) / last;
         uint8_t y2 = scale_y(graph, values[i + 1]);
 
         ssd1306_line(ssd, x1, y1, x2, y2, true);
     }
 }
 
-void draw_bar_graph(ssd1306_t *ssd, Graph *graph, float *values, uint8_t num_bars)
+void draw_bar_graph(ssd1306_t *ssd, Graph *graph, const int16_t *values, uint8_t num_bars)
 {
-    float bar_width = (float)graph->width / num_bars;
+    if (num_bars == 0)
+        return;
+
+    uint8_t bar_width = graph->width / num_bars;
 
     for (uint8_t i = 0; i < num_bars; i++)
     {
-        uint8_t x = graph->x_offset + (i * bar_width);
+        uint8_t x = graph->x_offset + (i * graph->width) / num_bars;
         uint8_t y = scale_y(graph, values[i]);
         uint8_t height = graph->y_offset + graph->height - y;
 
@@ -101,32 +104,28 @@ void draw_grid(ssd1306_t *ssd, Graph *graph)
 
 void clear_graph_area(ssd1306_t *ssd, Graph *graph)
 {
-    for (uint8_t x = graph->x_offset; x < graph->x_offset + graph->width; x++)
-    {
-        for (uint8_t y = graph->y_offset; y < graph->y_offset + graph->height; y++)
-        {
-            ssd1306_pixel(ssd, x, y, false);
-        }
-    }
+    ssd1306_fill_rect(ssd, graph->y_offset, graph->x_offset, graph->width, graph->height, false);
 }
 
-uint8_t scale_x(Graph *graph, float x)
+uint8_t scale_x(Graph *graph, uint16_t x_q8)
 {
-    return graph->x_offset + (x * graph->width);
+    return graph->x_offset + ((x_q8 * graph->width) >> 8);
 }
 
-uint8_t scale_y(Graph *graph, float y)
+uint8_t scale_y(Graph *graph, int16_t y)
 {
     // Limita o valor ao range definido
     if (y > graph->y_max) y = graph->y_max;
     if (y < graph->y_min) y = graph->y_min;
 
     // Converte o valor para a escala de pixels
-    float scale = (float)graph->height / (graph->y_max - graph->y_min);
-    return graph->y_offset + graph->height - ((y - graph->y_min) * scale);
+    int32_t range = (int32_t)graph->y_max - graph->y_min;
+    if (range <= 0)
+        return graph->y_offset + graph->height;
+    return graph->y_offset + graph->height - (((int32_t)y - graph->y_min) * graph->height) / range;
 }
 
-Graph create_graph(float y_min, float y_max)
+Graph create_graph(int16_t y_min, int16_t y_max)
 {
     Graph graph = {
         .x_offset = MARGIN_LEFT,
@@ -16,35 +16,37 @@ typedef struct
     uint8_t y;
 } Point;
 
-// Estrutura para representar um gráfico
+// Estrutura para representar um gráfico. Os valores do eixo Y são inteiros
+// na unidade do chamador (ex: centésimos de grau); nada aqui usa float.
 typedef struct
 {
     uint8_t x_offset;
     uint8_t y_offset;
     uint8_t width;
     uint8_t height;
-    float y_min;         // Valor mínimo real (ex: 0°C)
-    float y_max;         // Valor máximo real (ex: 100°C)
+    int16_t y_min;       // Valor mínimo real (ex: 0°C em centésimos = 0)
+    int16_t y_max;       // Valor máximo real (ex: 100°C em centésimos = 10000)
     uint8_t y_pixels;    // Quantidade de pixels no eixo Y
     uint8_t x_divisions; // Novo campo
     uint8_t y_divisions; // Novo campo
 } Graph;
 
 // Função para criar e configurar o gráfico
-Graph create_graph(float y_min, float y_max);
+Graph create_graph(int16_t y_min, int16_t y_max);
 
 // Função para converter valor real para posição em pixels
-uint8_t scale_value_to_pixel(Graph *graph, float value);
+uint8_t scale_value_to_pixel(Graph *graph, int16_t value);
 
 // Funções para desenhar gráficos
 void draw_axis(ssd1306_t *ssd, const char *x_label, const char *y_label);
-void draw_point(ssd1306_t *ssd, Graph *graph, float x, float y);
-void draw_line_graph(ssd1306_t *ssd, Graph *graph, float *values, uint8_t num_points);
-void draw_bar_graph(ssd1306_t *ssd, Graph *graph, float *values, uint8_t num_bars);
+void draw_point(ssd1306_t *ssd, Graph *graph, uint16_t x_q8, int16_t y);
+void draw_line_graph(ssd1306_t *ssd, Graph *graph, const int16_t *values, uint8_t num_points);
+void draw_bar_graph(ssd1306_t *ssd, Graph *graph, const int16_t *values, uint8_t num_bars);
+void draw_grid(ssd1306_t *ssd, Graph *graph);
 void clear_graph_area(ssd1306_t *ssd, Graph *graph);
 
-// Funções auxiliares
-uint8_t scale_x(Graph *graph, float x);
-uint8_t scale_y(Graph *graph, float y);
+// Funções auxiliares (x em fração da largura, Q0.8: 0 a 256)
+uint8_t scale_x(Graph *graph, uint16_t x_q8);
+uint8_t scale_y(Graph *graph, int16_t y);
 
 #endif // GRAPHICS_H
\ No newline at end of file
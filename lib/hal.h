@@ -0,0 +1,87 @@
+#ifndef HAL_H
+#define HAL_H
+
+#include "pico/stdlib.h"
+#include "ssd1306.h"
+#include "sensor_scan.h"
+
+// Camada fina entre a aplicação e o hardware: tempo, ADC, display, LED e
+// botões. lib/hal_pico.c implementa sobre o SDK do Pico; sim/hal_linux.c
+// sobre um relógio simulado, uma série de temperaturas e quadros em PBM,
+// para rodar aquisição, estatísticas, alertas e telas num PC.
+
+// Tempo desde o início
+uint32_t hal_time_ms(void);
+uint32_t hal_time_us(void);
+
+// Contador de ciclos para medidas curtas: no RP2040 o SysTick de cada núcleo
+// (24 bits, dá a volta a cada 134 ms a 125 MHz), habilitado por
+// hal_cycles_init() no núcleo que mede. Diferenças com & HAL_CYCLES_MASK.
+#define HAL_CYCLES_MASK 0x00FFFFFFu
+
+void hal_cycles_init(void);
+uint32_t hal_cycles_hz(void);
+
+#if PICO_ON_DEVICE
+#include "hardware/structs/systick.h"
+
+// Uma leitura de registrador: barato o bastante para os caminhos quentes
+static inline uint32_t hal_cycles(void)
+{
+    return HAL_CYCLES_MASK - systick_hw->cvr;
+}
+#else
+uint32_t hal_cycles(void);
+#endif
+
+// Varredura periódica dos sensores de temperatura
+typedef struct
+{
+    const sensor_channel_t *channels;
+    uint8_t channel_count;
+    const sensor_mux_t *mux;
+    uint8_t adc_input;      // Entrada do ADC usada pelo amostrador
+    uint8_t oversample_log2;
+    uint32_t interval_ms;   // Período entre varreduras
+} hal_sensor_config_t;
+
+// Recebe cada varredura completa: uma leitura Q12.4 por canal
+typedef void (*hal_scan_callback_t)(const uint16_t *adc_q4, uint32_t scans);
+
+// Inicia as varreduras; `done` roda no contexto da aquisição (no Pico, as
+// IRQs do núcleo 1)
+void hal_sensors_start(const hal_sensor_config_t *config, hal_scan_callback_t done);
+
+// Entradas auxiliares do ADC (joystick), 12 bits
+void hal_adc_init(uint8_t input);
+uint16_t hal_adc_read_aux(uint8_t input);
+
+// Display: destino dos quadros do ssd1306
+typedef struct
+{
+    i2c_inst_t *i2c;
+    uint8_t sda_pin;
+    uint8_t scl_pin;
+    uint8_t address;
+    uint32_t baudrate;
+} hal_display_config_t;
+
+// `done` é chamado (em IRQ no Pico) quando um envio termina
+void hal_display_init(ssd1306_t *ssd, const hal_display_config_t *config,
+                      ssd1306_flush_callback_t done, void *context);
+bool hal_display_busy(ssd1306_t *ssd);
+// Envia as regiões alteradas do framebuffer; falso se não havia mudanças
+bool hal_display_flush(ssd1306_t *ssd);
+
+// LED por PWM, nível de 0 a HAL_LED_WRAP
+#define HAL_LED_WRAP 2000
+
+void hal_led_init(uint gpio);
+void hal_led_set(uint gpio, uint16_t level);
+
+// Botões com pull-up; o callback roda na borda de descida
+typedef void (*hal_button_callback_t)(uint gpio, uint32_t events);
+
+void hal_button_init(uint gpio, hal_button_callback_t callback);
+
+#endif // HAL_H
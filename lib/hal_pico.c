@@ -0,0 +1,146 @@
+#include "hal.h"
+#include "adc_sampler.h"
+#include "pico/multicore.h"
+#include "pico/flash.h"
+#include "hardware/adc.h"
+#include "hardware/clocks.h"
+#include "hardware/i2c.h"
+#include "hardware/pwm.h"
+#include "hardware/sync.h"
+#include "hardware/structs/systick.h"
+
+#define HAL_LED_CLKDIV 1250 // 125 MHz / 1250 / 2000 = 50 Hz
+#define HAL_SYSTICK_PROCESSOR_CLOCK 0x5 // ENABLE | CLKSOURCE, sem interrupção
+
+static const hal_sensor_config_t *sensor_config;
+static hal_scan_callback_t scan_callback;
+
+uint32_t hal_time_ms(void)
+{
+    return to_ms_since_boot(get_absolute_time());
+}
+
+uint32_t hal_time_us(void)
+{
+    return time_us_32();
+}
+
+void hal_cycles_init(void)
+{
+    systick_hw->rvr = HAL_CYCLES_MASK;
+    systick_hw->cvr = 0;
+    systick_hw->csr = HAL_SYSTICK_PROCESSOR_CLOCK;
+}
+
+uint32_t hal_cycles_hz(void)
+{
+    return clock_get_hz(clk_sys);
+}
+
+static void hal_scan_done(const sensor_scan_state_t *scan)
+{
+    scan_callback(scan->latest, scan->scans);
+}
+
+// Dispara a varredura, que segue por IRQ
+static bool hal_scan_timer(struct repeating_timer *t)
+{
+    sensor_scan_start();
+    return true;
+}
+
+// Núcleo 1: aquisição, histórico e alertas.
+// O timer, o DMA do ADC e o alarme de acomodação têm as IRQs habilitadas
+// neste núcleo, de modo que a latência do alerta não depende do que o
+// núcleo 0 estiver fazendo (renderização, envio ao display, botões).
+static void hal_core1_entry(void)
+{
+    // Permite ao núcleo 0 pausar este núcleo durante gravações na flash
+    flash_safe_execute_core_init();
+    hal_cycles_init();
+
+    // Pool de alarmes próprio: as IRQs do timer ficam no núcleo 1
+    alarm_pool_t *pool = alarm_pool_create_with_unused_hardware_alarm(4);
+
+    adc_sampler_init(sensor_config->adc_input, sensor_config->oversample_log2);
+    sensor_scan_init(sensor_config->channels, sensor_config->channel_count, sensor_config->mux,
+                     sensor_config->oversample_log2, pool, hal_scan_done);
+
+    struct repeating_timer timer;
+    alarm_pool_add_repeating_timer_ms(pool, sensor_config->interval_ms, hal_scan_timer, NULL, &timer);
+
+    while (true)
+    {
+        __wfi(); // Todo o trabalho acontece nas IRQs
+    }
+}
+
+void hal_sensors_start(const hal_sensor_config_t *config, hal_scan_callback_t done)
+{
+    sensor_config = config;
+    scan_callback = done;
+    multicore_launch_core1(hal_core1_entry);
+}
+
+void hal_adc_init(uint8_t input)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        adc_init();
+        initialized = true;
+    }
+    adc_gpio_init(26 + input);
+}
+
+uint16_t hal_adc_read_aux(uint8_t input)
+{
+    return adc_sampler_read_aux(input);
+}
+
+void hal_display_init(ssd1306_t *ssd, const hal_display_config_t *config,
+                      ssd1306_flush_callback_t done, void *context)
+{
+    i2c_init(config->i2c, config->baudrate);
+    gpio_set_function(config->sda_pin, GPIO_FUNC_I2C);
+    gpio_set_function(config->scl_pin, GPIO_FUNC_I2C);
+    gpio_pull_up(config->sda_pin);
+    gpio_pull_up(config->scl_pin);
+
+    ssd1306_init(ssd, 128, 64, false, config->address, config->i2c);
+    ssd1306_config(ssd);
+    ssd1306_dma_init(ssd); // Envio do framebuffer por DMA, sem bloquear o loop
+    ssd1306_set_flush_callback(ssd, done, context);
+}
+
+bool hal_display_busy(ssd1306_t *ssd)
+{
+    return ssd1306_flush_busy(ssd);
+}
+
+bool hal_display_flush(ssd1306_t *ssd)
+{
+    return ssd1306_send_data_async(ssd);
+}
+
+void hal_led_init(uint gpio)
+{
+    gpio_set_function(gpio, GPIO_FUNC_PWM);
+    uint slice = pwm_gpio_to_slice_num(gpio);
+    pwm_set_clkdiv(slice, HAL_LED_CLKDIV);
+    pwm_set_wrap(slice, HAL_LED_WRAP);
+    pwm_set_enabled(slice, true);
+}
+
+void hal_led_set(uint gpio, uint16_t level)
+{
+    pwm_set_gpio_level(gpio, level);
+}
+
+void hal_button_init(uint gpio, hal_button_callback_t callback)
+{
+    gpio_init(gpio);
+    gpio_set_dir(gpio, GPIO_IN);
+    gpio_pull_up(gpio);
+    gpio_set_irq_enabled_with_callback(gpio, GPIO_IRQ_EDGE_FALL, true, callback);
+}
@@ -0,0 +1,209 @@
+#include "history.h"
+#include <string.h>
+
+// Registros do nível de baixo resumidos em um registro de cada nível
+static const uint16_t tier_fold[HISTORY_TIER_COUNT] = {1, 60, 15, 4};
+static const uint16_t tier_size[HISTORY_TIER_COUNT] = {
+    HISTORY_SECONDS_SIZE, HISTORY_MINUTES_SIZE, HISTORY_QUARTERS_SIZE, HISTORY_HOURS_SIZE};
+
+static history_record_t *history_tier_records(history_channel_t *history, uint tier)
+{
+    switch (tier)
+    {
+    case HISTORY_TIER_MINUTES:
+        return history->minutes;
+    case HISTORY_TIER_QUARTERS:
+        return history->quarters;
+    default:
+        return history->hours;
+    }
+}
+
+static history_block_t *history_tier_blocks(history_channel_t *history, uint tier)
+{
+    switch (tier)
+    {
+    case HISTORY_TIER_SECONDS:
+        return history->seconds_blocks;
+    case HISTORY_TIER_MINUTES:
+        return history->minutes_blocks;
+    case HISTORY_TIER_QUARTERS:
+        return history->quarters_blocks;
+    default:
+        return history->hours_blocks;
+    }
+}
+
+static const history_block_t empty_block = {
+    .min = TEMP_CENTI_HIGHEST, .max = TEMP_CENTI_LOWEST, .sum = 0};
+
+// Registro na posição física `position` do anel do nível
+static history_record_t history_at(const history_channel_t *history, uint tier, uint position)
+{
+    if (tier == HISTORY_TIER_SECONDS)
+    {
+        temp_centi_t sample = history->seconds[position];
+        return (history_record_t){.min = sample, .max = sample, .mean = sample};
+    }
+    return history_tier_records((history_channel_t *)history, tier)[position];
+}
+
+static inline void history_block_add(history_block_t *into, history_record_t record)
+{
+    if (record.min < into->min)
+        into->min = record.min;
+    if (record.max > into->max)
+        into->max = record.max;
+    into->sum += record.mean;
+}
+
+// Refaz o resumo do bloco da posição alterada. As posições do anel são
+// gravadas em ordem, então um bloco só entra inteiro numa consulta depois
+// que todas as suas posições foram gravadas, e o último resumo já as viu.
+static void history_block_update(history_channel_t *history, uint tier, uint position)
+{
+    uint first = position - position % HISTORY_BLOCK_SIZE;
+    uint last = first + HISTORY_BLOCK_SIZE;
+    if (last > tier_size[tier])
+        last = tier_size[tier];
+    history_block_t block = empty_block;
+    for (uint i = first; i < last; i++)
+        history_block_add(&block, history_at(history, tier, i));
+    history_tier_blocks(history, tier)[position / HISTORY_BLOCK_SIZE] = block;
+}
+
+// Resumo das posições físicas [from, to) do anel: registros avulsos nas
+// pontas, blocos inteiros no meio
+static void history_blocks_query(const history_channel_t *history, uint tier, uint from, uint to,
+                                 history_block_t *acc)
+{
+    const history_block_t *blocks = history_tier_blocks((history_channel_t *)history, tier);
+    while (from < to && from % HISTORY_BLOCK_SIZE)
+        history_block_add(acc, history_at(history, tier, from++));
+    for (; to - from >= HISTORY_BLOCK_SIZE; from += HISTORY_BLOCK_SIZE)
+    {
+        const history_block_t *block = &blocks[from / HISTORY_BLOCK_SIZE];
+        if (block->min < acc->min)
+            acc->min = block->min;
+        if (block->max > acc->max)
+            acc->max = block->max;
+        acc->sum += block->sum;
+    }
+    while (from < to)
+        history_block_add(acc, history_at(history, tier, from++));
+}
+
+static void history_accumulator_reset(history_accumulator_t *pending)
+{
+    pending->min = TEMP_CENTI_HIGHEST;
+    pending->max = TEMP_CENTI_LOWEST;
+    pending->sum = 0;
+    pending->count = 0;
+}
+
+// Avança o anel do nível e devolve a posição do novo registro
+static uint history_ring_push(history_channel_t *history, uint tier)
+{
+    history_ring_t *ring = &history->rings[tier];
+    ring->newest = (ring->newest + 1) % tier_size[tier];
+    if (ring->count < tier_size[tier])
+        ring->count++;
+    ring->total++;
+    return ring->newest;
+}
+
+void history_init(history_channel_t *history)
+{
+    memset(history, 0, sizeof(*history));
+    for (uint tier = 0; tier < HISTORY_TIER_COUNT; tier++)
+    {
+        // O primeiro push leva o registro mais novo para a posição 0
+        history->rings[tier].newest = tier_size[tier] - 1;
+        history_accumulator_reset(&history->pending[tier]);
+    }
+}
+
+uint history_add(history_channel_t *history, temp_centi_t sample)
+{
+    uint position = history_ring_push(history, HISTORY_TIER_SECONDS);
+    history->seconds[position] = sample;
+    history_block_update(history, HISTORY_TIER_SECONDS, position);
+
+    history_record_t record = {.min = sample, .max = sample, .mean = sample};
+    for (uint tier = 1; tier < HISTORY_TIER_COUNT; tier++)
+    {
+        history_accumulator_t *pending = &history->pending[tier];
+        if (record.min < pending->min)
+            pending->min = record.min;
+        if (record.max > pending->max)
+            pending->max = record.max;
+        pending->sum += record.mean;
+        if (++pending->count < tier_fold[tier])
+            return tier - 1;
+
+        // Bloco completo: fecha o registro e o repassa ao próximo nível
+        record.min = pending->min;
+        record.max = pending->max;
+        record.mean = pending->sum / pending->count;
+        position = history_ring_push(history, tier);
+        history_tier_records(history, tier)[position] = record;
+        history_block_update(history, tier, position);
+        history_accumulator_reset(pending);
+    }
+    return HISTORY_TIER_COUNT - 1;
+}
+
+uint history_count(const history_channel_t *history, uint tier)
+{
+    return tier < HISTORY_TIER_COUNT ? history->rings[tier].count : 0;
+}
+
+uint32_t history_written(const history_channel_t *history, uint tier)
+{
+    return tier < HISTORY_TIER_COUNT ? history->rings[tier].total : 0;
+}
+
+history_record_t history_get(const history_channel_t *history, uint tier, uint age)
+{
+    const history_ring_t *ring = &history->rings[tier];
+    return history_at(history, tier, (ring->newest + tier_size[tier] - age) % tier_size[tier]);
+}
+
+uint history_range(const history_channel_t *history, uint tier, uint from_age, uint to_age,
+                   history_record_t *out)
+{
+    const history_ring_t *ring = &history->rings[tier];
+    if (to_age > ring->count)
+        to_age = ring->count;
+    if (from_age >= to_age)
+        return 0;
+
+    // Idades crescem para trás no anel: o trecho vai do mais antigo (to_age - 1)
+    // ao mais novo (from_age) e pode dar a volta no fim do vetor
+    uint size = tier_size[tier];
+    uint count = to_age - from_age;
+    uint start = (ring->newest + size - (to_age - 1)) % size;
+    history_block_t acc = empty_block;
+    if (start + count <= size)
+    {
+        history_blocks_query(history, tier, start, start + count, &acc);
+    }
+    else
+    {
+        history_blocks_query(history, tier, start, size, &acc);
+        history_blocks_query(history, tier, 0, start + count - size, &acc);
+    }
+
+    out->min = acc.min;
+    out->max = acc.max;
+    out->mean = acc.sum / (int32_t)count;
+    return count;
+}
+
+uint32_t history_tier_seconds(uint tier)
+{
+    uint32_t seconds = 1;
+    for (uint i = 1; i <= tier && i < HISTORY_TIER_COUNT; i++)
+        seconds *= tier_fold[i];
+    return seconds;
+}
@@ -0,0 +1,107 @@
+#ifndef HISTORY_H
+#define HISTORY_H
+
+#include "pico/stdlib.h"
+#include "temperature.h"
+
+// Histórico de um canal em níveis de resolução.
+//
+// O nível 0 guarda as amostras de 1 s. Cada nível acima resume um bloco de
+// registros do nível de baixo em mínimo, máximo e média. Por padrão são
+// 128 x 1 s, 128 x 1 min, 128 x 15 min e 96 x 1 h: dois minutos em detalhe e
+// quatro dias de tendência. Cada nível acumula incrementalmente.
+//
+// Cada nível guarda também o resumo (mínimo, máximo e soma das médias) de
+// cada bloco de HISTORY_BLOCK_SIZE posições do seu anel: mínimo, máximo e
+// média de um trecho saem dos blocos inteiros mais os registros das pontas,
+// em O(n / B + B), sem uma árvore por canal. Gravar um registro refaz o resumo
+// do bloco dele (B leituras). São cerca de 2,7 KB por canal.
+
+#define HISTORY_TIER_SECONDS 0
+#define HISTORY_TIER_MINUTES 1
+#define HISTORY_TIER_QUARTERS 2
+#define HISTORY_TIER_HOURS 3
+#define HISTORY_TIER_COUNT 4
+
+#define HISTORY_SECONDS_SIZE 128
+#define HISTORY_MINUTES_SIZE 128
+#define HISTORY_QUARTERS_SIZE 128
+#define HISTORY_HOURS_SIZE 96
+#define HISTORY_MAX_TIER_SIZE 128
+#define HISTORY_BLOCK_SIZE 16
+#define HISTORY_BLOCKS(size) (((size) + HISTORY_BLOCK_SIZE - 1) / HISTORY_BLOCK_SIZE)
+
+typedef struct
+{
+    temp_centi_t min;
+    temp_centi_t max;
+    temp_centi_t mean;
+} history_record_t;
+
+// Posição do registro mais novo e quantidade retida em um nível
+typedef struct
+{
+    uint16_t newest;
+    uint16_t count;
+    uint32_t total; // Registros já gravados: índice absoluto do próximo
+} history_ring_t;
+
+// Bloco em formação de um nível acima do 0
+typedef struct
+{
+    temp_centi_t min;
+    temp_centi_t max;
+    int32_t sum;
+    uint16_t count;
+} history_accumulator_t;
+
+// Resumo de um bloco do anel
+typedef struct
+{
+    temp_centi_t min;
+    temp_centi_t max;
+    int32_t sum; // Soma das médias
+} history_block_t;
+
+typedef struct
+{
+    temp_centi_t seconds[HISTORY_SECONDS_SIZE];
+    history_record_t minutes[HISTORY_MINUTES_SIZE];
+    history_record_t quarters[HISTORY_QUARTERS_SIZE];
+    history_record_t hours[HISTORY_HOURS_SIZE];
+    history_ring_t rings[HISTORY_TIER_COUNT];
+    history_accumulator_t pending[HISTORY_TIER_COUNT]; // Índice 0 não usado
+    history_block_t seconds_blocks[HISTORY_BLOCKS(HISTORY_SECONDS_SIZE)];
+    history_block_t minutes_blocks[HISTORY_BLOCKS(HISTORY_MINUTES_SIZE)];
+    history_block_t quarters_blocks[HISTORY_BLOCKS(HISTORY_QUARTERS_SIZE)];
+    history_block_t hours_blocks[HISTORY_BLOCKS(HISTORY_HOURS_SIZE)];
+} history_channel_t;
+
+void history_init(history_channel_t *history);
+
+// Acrescenta a amostra de 1 s e fecha os blocos dos níveis acima que
+// completarem. Devolve o nível mais alto que ganhou um registro novo
+// (HISTORY_TIER_SECONDS se nenhum bloco fechou)
+uint history_add(history_channel_t *history, temp_centi_t sample);
+
+uint history_count(const history_channel_t *history, uint tier);
+
+// Registros gravados no nível desde o início. O registro de índice absoluto
+// i tem idade total - 1 - i e continua no anel enquanto essa idade for menor
+// que history_count(); ao contrário das idades, o índice não muda quando
+// chegam registros novos.
+uint32_t history_written(const history_channel_t *history, uint tier);
+
+// Registro `age` de um nível (0 = mais novo); no nível 0 mínimo = máximo = média
+history_record_t history_get(const history_channel_t *history, uint tier, uint age);
+
+// Resumo dos registros com idade em [from_age, to_age) de um nível, em
+// O(n / B + B): mínimo dos mínimos, máximo dos máximos e média das médias.
+// Devolve a quantidade de registros considerados (0 se o trecho está vazio).
+uint history_range(const history_channel_t *history, uint tier, uint from_age, uint to_age,
+                   history_record_t *out);
+
+// Duração de um registro do nível, em segundos
+uint32_t history_tier_seconds(uint tier);
+
+#endif // HISTORY_H
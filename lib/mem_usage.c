@@ -0,0 +1,56 @@
+#include "mem_usage.h"
+#include <malloc.h>
+#include "hardware/regs/addressmap.h"
+
+#define MEM_STACK_PAINT 0x5A5A5A5Au
+#define MEM_STACK_MARGIN 64 // Bytes logo abaixo do SP atual que não são pintados
+
+// Símbolos do linker script do SDK
+extern uint32_t __StackBottom, __StackTop, __StackOneBottom, __StackOneTop;
+extern char __end__, __HeapLimit;
+
+static uint32_t heap_peak;
+
+static void mem_paint(uint32_t *bottom, uint32_t *end)
+{
+    for (uint32_t *word = bottom; word < end; word++)
+    {
+        *word = MEM_STACK_PAINT;
+    }
+}
+
+// Uso a partir do topo: a primeira palavra alterada, vindo do fundo
+static uint32_t mem_stack_peak(const uint32_t *bottom, const uint32_t *top)
+{
+    const uint32_t *word = bottom;
+    while (word < top && *word == MEM_STACK_PAINT)
+        word++;
+    return (uint32_t)(top - word) * sizeof(uint32_t);
+}
+
+void mem_usage_init(void)
+{
+    // Núcleo 0: só abaixo do quadro atual, com folga para esta função
+    uint32_t marker;
+    mem_paint(&__StackBottom, (uint32_t *)((uintptr_t)&marker - MEM_STACK_MARGIN));
+
+    // Núcleo 1: ainda parado, a pilha inteira
+    mem_paint(&__StackOneBottom, &__StackOneTop);
+}
+
+void mem_usage_read(mem_usage_t *usage)
+{
+    struct mallinfo info = mallinfo();
+    if ((uint32_t)info.arena > heap_peak)
+        heap_peak = info.arena;
+
+    usage->static_bytes = (uintptr_t)&__end__ - SRAM_BASE;
+    usage->heap.size = &__HeapLimit - &__end__;
+    usage->heap.peak = heap_peak;
+    usage->heap_in_use = info.uordblks;
+
+    usage->stack[0].size = (uintptr_t)&__StackTop - (uintptr_t)&__StackBottom;
+    usage->stack[0].peak = mem_stack_peak(&__StackBottom, &__StackTop);
+    usage->stack[1].size = (uintptr_t)&__StackOneTop - (uintptr_t)&__StackOneBottom;
+    usage->stack[1].peak = mem_stack_peak(&__StackOneBottom, &__StackOneTop);
+}
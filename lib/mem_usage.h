@@ -0,0 +1,39 @@
+#ifndef MEM_USAGE_H
+#define MEM_USAGE_H
+
+#include "pico/stdlib.h"
+
+// Uso de memória em execução: pilhas dos dois núcleos e heap.
+//
+// mem_usage_init() pinta com um padrão a parte livre da pilha do núcleo 0
+// e toda a pilha do núcleo 1 (por isso roda antes de lançá-lo). O pico de
+// cada pilha é a distância do topo à palavra pintada mais funda que foi
+// sobrescrita. As áreas são as reservadas pelo linker do SDK (__StackBottom
+// e __StackOneBottom, PICO_STACK_SIZE e PICO_CORE1_STACK_SIZE); pico igual ao
+// tamanho indica que a pilha pode ter passado do limite.
+//
+// O heap (ssd1306, stdio) vai do fim do bss ao fim da RAM; o pico é a maior
+// área que o malloc já pediu ao sistema, e o uso atual vem do mallinfo().
+// A parte estática (código copiado para a RAM, dados e bss) é fixa e sai por
+// módulo no relatório do build (tools/mem_report.py).
+
+typedef struct
+{
+    uint32_t size; // Bytes reservados
+    uint32_t peak; // Maior uso observado
+} mem_usage_area_t;
+
+typedef struct
+{
+    uint32_t static_bytes;     // Do início da RAM ao heap
+    mem_usage_area_t heap;     // peak: maior área obtida do sistema
+    uint32_t heap_in_use;      // Bytes alocados agora
+    mem_usage_area_t stack[2]; // Núcleos 0 e 1
+} mem_usage_t;
+
+// Chamar no núcleo 0, no início do main e antes de lançar o núcleo 1
+void mem_usage_init(void);
+
+void mem_usage_read(mem_usage_t *usage);
+
+#endif // MEM_USAGE_H
@@ -0,0 +1,241 @@
+#include "modbus_rtu.h"
+#include "crc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "hardware/timer.h"
+
+#define MODBUS_MIN_FRAME 4          // Endereço, função e CRC
+#define MODBUS_CHAR_BITS 11         // Início, 8 dados, paridade (ou 2ª parada) e parada
+#define MODBUS_FIXED_T35_US 1750    // Acima de 19200 bps a norma fixa os tempos
+#define MODBUS_FIXED_T35_BAUD 19200
+
+// Bits de erro que a UART devolve junto com cada byte
+#define MODBUS_RX_ERROR_BITS (UART_UARTDR_OE_BITS | UART_UARTDR_BE_BITS | \
+                              UART_UARTDR_PE_BITS | UART_UARTDR_FE_BITS)
+
+static struct
+{
+    uart_inst_t *uart;
+    uint8_t address;
+    const modbus_map_t *map;
+    uint alarm;
+    int dma_channel;
+    uint32_t t35_us;
+    uint8_t rx[MODBUS_ADU_SIZE];
+    uint16_t rx_length;
+    bool rx_invalid;       // Estouro ou erro de caractere no quadro em curso
+    uint32_t last_byte_us; // Instante do último byte recebido
+    uint8_t tx[MODBUS_ADU_SIZE];
+} bus = {.dma_channel = -1};
+
+static modbus_rtu_stats_t stats;
+
+static inline uint16_t get_be16(const uint8_t *bytes)
+{
+    return (bytes[0] << 8) | bytes[1];
+}
+
+static inline void put_be16(uint8_t *bytes, uint16_t value)
+{
+    bytes[0] = value >> 8;
+    bytes[1] = value & 0xFF;
+}
+
+static size_t modbus_exception(uint8_t *response, uint8_t code)
+{
+    response[1] |= 0x80;
+    response[2] = code;
+    stats.exceptions++;
+    return 3;
+}
+
+// Atende um pedido (sem o CRC) e monta a resposta em `response`, também sem
+// o CRC; devolve o tamanho da resposta
+static size_t modbus_process(const uint8_t *request, size_t length, uint8_t *response)
+{
+    uint16_t registers[MODBUS_MAX_READ];
+    uint8_t function = request[1];
+    response[0] = request[0];
+    response[1] = function;
+
+    switch (function)
+    {
+    case 0x03:
+    case 0x04:
+    {
+        modbus_read_callback_t read = function == 0x03 ? bus.map->read_holding : bus.map->read_input;
+        if (!read)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_FUNCTION);
+        if (length != 6)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_VALUE);
+        uint16_t address = get_be16(&request[2]);
+        uint16_t count = get_be16(&request[4]);
+        if (count == 0 || count > MODBUS_MAX_READ)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_VALUE);
+        if (address + count > 0x10000)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_ADDRESS);
+        uint8_t code = read(address, count, registers);
+        if (code)
+            return modbus_exception(response, code);
+        response[2] = count * 2;
+        for (uint16_t i = 0; i < count; i++)
+        {
+            put_be16(&response[3 + 2 * i], registers[i]);
+        }
+        return 3 + count * 2;
+    }
+    case 0x06:
+    {
+        if (!bus.map->write_holding)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_FUNCTION);
+        if (length != 6)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_VALUE);
+        registers[0] = get_be16(&request[4]);
+        uint8_t code = bus.map->write_holding(get_be16(&request[2]), 1, registers);
+        if (code)
+            return modbus_exception(response, code);
+        // A resposta repete o pedido
+        for (size_t i = 2; i < 6; i++)
+        {
+            response[i] = request[i];
+        }
+        return 6;
+    }
+    case 0x10:
+    {
+        if (!bus.map->write_holding)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_FUNCTION);
+        if (length < 7)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_VALUE);
+        uint16_t address = get_be16(&request[2]);
+        uint16_t count = get_be16(&request[4]);
+        if (count == 0 || count > MODBUS_MAX_WRITE || request[6] != count * 2 ||
+            length != 7u + count * 2)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_VALUE);
+        if (address + count > 0x10000)
+            return modbus_exception(response, MODBUS_EX_ILLEGAL_ADDRESS);
+        for (uint16_t i = 0; i < count; i++)
+        {
+            registers[i] = get_be16(&request[7 + 2 * i]);
+        }
+        uint8_t code = bus.map->write_holding(address, count, registers);
+        if (code)
+            return modbus_exception(response, code);
+        // A resposta confirma endereço e quantidade
+        for (size_t i = 2; i < 6; i++)
+        {
+            response[i] = request[i];
+        }
+        return 6;
+    }
+    default:
+        return modbus_exception(response, MODBUS_EX_ILLEGAL_FUNCTION);
+    }
+}
+
+// Alarme de 3,5 caracteres: a linha ficou em silêncio e o quadro terminou
+static void __not_in_flash_func(modbus_frame_end)(uint alarm)
+{
+    uint16_t length = bus.rx_length;
+    bool invalid = bus.rx_invalid;
+    bus.rx_length = 0;
+    bus.rx_invalid = false;
+
+    if (length == 0)
+        return;
+    if (invalid || length < MODBUS_MIN_FRAME)
+    {
+        stats.discarded++;
+        return;
+    }
+    uint16_t crc = bus.rx[length - 2] | (bus.rx[length - 1] << 8);
+    if (crc != crc16_modbus(bus.rx, length - 2))
+    {
+        stats.crc_errors++;
+        return;
+    }
+    uint8_t address = bus.rx[0];
+    if (address != bus.address && address != 0)
+        return; // Pedido para outro escravo
+    stats.requests++;
+
+    if (dma_channel_is_busy(bus.dma_channel))
+    {
+        // O mestre não esperou a resposta anterior terminar
+        stats.busy++;
+        return;
+    }
+    size_t size = modbus_process(bus.rx, length - 2, bus.tx);
+    if (address == 0)
+        return; // Broadcast não tem resposta
+
+    crc = crc16_modbus(bus.tx, size);
+    bus.tx[size++] = crc & 0xFF;
+    bus.tx[size++] = crc >> 8;
+    dma_channel_set_read_addr(bus.dma_channel, bus.tx, false);
+    dma_channel_set_trans_count(bus.dma_channel, size, true);
+
+    stats.last_latency_us = time_us_32() - bus.last_byte_us;
+    if (stats.last_latency_us > stats.max_latency_us)
+        stats.max_latency_us = stats.last_latency_us;
+}
+
+static void __not_in_flash_func(modbus_uart_handler)(void)
+{
+    uart_hw_t *hw = uart_get_hw(bus.uart);
+    while (uart_is_readable(bus.uart))
+    {
+        uint32_t data = hw->dr;
+        if (data & MODBUS_RX_ERROR_BITS)
+            bus.rx_invalid = true;
+        if (bus.rx_length < sizeof(bus.rx))
+            bus.rx[bus.rx_length++] = data & 0xFF;
+        else
+            bus.rx_invalid = true;
+    }
+    // Cada byte adia o fim do quadro
+    bus.last_byte_us = time_us_32();
+    hardware_alarm_set_target(bus.alarm, make_timeout_time_us(bus.t35_us));
+}
+
+void modbus_rtu_init(const modbus_rtu_config_t *config, const modbus_map_t *map)
+{
+    bus.uart = config->uart;
+    bus.address = config->address;
+    bus.map = map;
+    bus.rx_length = 0;
+    bus.rx_invalid = false;
+    bus.t35_us = config->baudrate > MODBUS_FIXED_T35_BAUD
+                     ? MODBUS_FIXED_T35_US
+                     : MODBUS_CHAR_BITS * 3500000u / config->baudrate; // 3,5 caracteres
+
+    uart_init(bus.uart, config->baudrate);
+    uart_set_format(bus.uart, 8, config->parity == UART_PARITY_NONE ? 2 : 1, config->parity);
+    uart_set_hw_flow(bus.uart, false, false);
+    // Sem FIFO: uma IRQ por byte, e o alarme parte do instante de cada um
+    uart_set_fifo_enabled(bus.uart, false);
+    gpio_set_function(config->tx_pin, GPIO_FUNC_UART);
+    gpio_set_function(config->rx_pin, GPIO_FUNC_UART);
+
+    bus.alarm = hardware_alarm_claim_unused(true);
+    hardware_alarm_set_callback(bus.alarm, modbus_frame_end);
+
+    // Resposta por DMA, no ritmo do DREQ de transmissão da UART
+    bus.dma_channel = dma_claim_unused_channel(true);
+    dma_channel_config dma = dma_channel_get_default_config(bus.dma_channel);
+    channel_config_set_transfer_data_size(&dma, DMA_SIZE_8);
+    channel_config_set_read_increment(&dma, true);
+    channel_config_set_write_increment(&dma, false);
+    channel_config_set_dreq(&dma, uart_get_dreq(bus.uart, true));
+    dma_channel_configure(bus.dma_channel, &dma, &uart_get_hw(bus.uart)->dr, bus.tx, 0, false);
+
+    uint irq = UART_IRQ_NUM(bus.uart);
+    irq_set_exclusive_handler(irq, modbus_uart_handler);
+    irq_set_enabled(irq, true);
+    uart_set_irq_enables(bus.uart, true, false);
+}
+
+const modbus_rtu_stats_t *modbus_rtu_stats(void)
+{
+    return &stats;
+}
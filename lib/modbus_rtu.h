@@ -0,0 +1,70 @@
+#ifndef MODBUS_RTU_H
+#define MODBUS_RTU_H
+
+#include "pico/stdlib.h"
+#include "hardware/uart.h"
+
+// Escravo Modbus RTU numa UART.
+//
+// A recepção roda toda por IRQ: com a FIFO da UART desligada cada byte gera
+// uma interrupção, que o guarda e reprograma um alarme de hardware para 3,5
+// caracteres depois (1750 us acima de 19200 bps, como pede a norma). Quando
+// o alarme dispara a linha ficou em silêncio e o quadro terminou: ele é
+// conferido e respondido ali mesmo, na IRQ do alarme, com a resposta saindo
+// por DMA. O laço principal não participa, então a latência não depende da
+// renderização nem das gravações na flash.
+//
+// As IRQs ficam no núcleo que chama modbus_rtu_init(). Sem controle de
+// direção: para RS-485 use um transceptor com direção automática.
+//
+// Funções aceitas: 0x03 e 0x04 (leitura de holding e input registers), 0x06
+// e 0x10 (escrita de holding registers). O mapa de registradores é de quem
+// chama, por callbacks que rodam na IRQ e devolvem 0 ou uma exceção
+// MODBUS_EX_*. O endereço 0 (broadcast) só aceita escritas, sem resposta.
+
+#define MODBUS_EX_ILLEGAL_FUNCTION 0x01
+#define MODBUS_EX_ILLEGAL_ADDRESS 0x02
+#define MODBUS_EX_ILLEGAL_VALUE 0x03
+
+#define MODBUS_MAX_READ 125  // Registradores por leitura (0x03, 0x04)
+#define MODBUS_MAX_WRITE 123 // Registradores por escrita (0x10)
+#define MODBUS_ADU_SIZE 256  // Maior quadro RTU
+
+// Leitura de `count` registradores a partir de `address`
+typedef uint8_t (*modbus_read_callback_t)(uint16_t address, uint16_t count, uint16_t *out);
+// Escrita de `count` registradores a partir de `address`
+typedef uint8_t (*modbus_write_callback_t)(uint16_t address, uint16_t count, const uint16_t *values);
+
+typedef struct
+{
+    modbus_read_callback_t read_input;     // 0x04
+    modbus_read_callback_t read_holding;   // 0x03
+    modbus_write_callback_t write_holding; // 0x06 e 0x10
+} modbus_map_t;
+
+typedef struct
+{
+    uart_inst_t *uart;
+    uint8_t tx_pin;
+    uint8_t rx_pin;
+    uint32_t baudrate;
+    uart_parity_t parity; // Padrão da norma: par; sem paridade usa 2 bits de parada
+    uint8_t address;      // 1 a 247
+} modbus_rtu_config_t;
+
+typedef struct
+{
+    uint32_t requests;        // Quadros para este endereço (ou broadcast)
+    uint32_t exceptions;      // Respostas de exceção
+    uint32_t crc_errors;      // Quadros com CRC errado
+    uint32_t discarded;       // Quadros curtos, longos demais ou com erro de caractere
+    uint32_t busy;            // Pedidos com a resposta anterior ainda saindo
+    uint32_t last_latency_us; // Do último byte do pedido ao início da resposta
+    uint32_t max_latency_us;
+} modbus_rtu_stats_t;
+
+void modbus_rtu_init(const modbus_rtu_config_t *config, const modbus_map_t *map);
+
+const modbus_rtu_stats_t *modbus_rtu_stats(void);
+
+#endif // MODBUS_RTU_H
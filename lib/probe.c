@@ -0,0 +1,111 @@
+#include "probe.h"
+#include "hardware/sync.h"
+
+#define PROBE_CORES 2
+
+static probe_event_t trace[PROBE_CORES][PROBE_TRACE_SIZE];
+static volatile uint32_t trace_head[PROBE_CORES]; // Eventos já escritos por núcleo
+
+void probe_reset(probe_stat_t *stat)
+{
+    stat->count = 0;
+    stat->min = 0;
+    stat->max = 0;
+    stat->sum = 0;
+    for (uint8_t k = 0; k < PROBE_HIST_BINS; k++)
+    {
+        stat->hist[k] = 0;
+    }
+}
+
+void __not_in_flash_func(probe_record)(probe_stat_t *stat, uint32_t value)
+{
+    // Estatística zerada por memset conta como vazia
+    if (stat->count == 0 || value < stat->min)
+        stat->min = value;
+    if (value > stat->max)
+        stat->max = value;
+    stat->sum += value;
+    stat->count++;
+
+    uint8_t bin = value ? 32 - __builtin_clz(value) : 0;
+    stat->hist[bin < PROBE_HIST_BINS ? bin : PROBE_HIST_BINS - 1]++;
+}
+
+uint32_t probe_mean(const probe_stat_t *stat)
+{
+    return stat->count ? (uint32_t)(stat->sum / stat->count) : 0;
+}
+
+void __not_in_flash_func(probe_interval)(probe_stat_t *stat, uint32_t *last_us, uint32_t expected_us)
+{
+    uint32_t now = hal_time_us();
+    if (*last_us != 0)
+    {
+        int32_t deviation = (int32_t)(now - *last_us - expected_us);
+        probe_record(stat, deviation < 0 ? -deviation : deviation);
+    }
+    *last_us = now;
+}
+
+uint32_t probe_percentile(const probe_stat_t *stat, uint16_t permille)
+{
+    uint64_t target = ((uint64_t)stat->count * permille + 999) / 1000;
+    uint64_t seen = 0;
+    for (uint8_t k = 0; k < PROBE_HIST_BINS; k++)
+    {
+        seen += stat->hist[k];
+        if (seen >= target && seen > 0)
+        {
+            uint32_t limit = k ? (1u << k) - 1 : 0;
+            return limit < stat->max ? limit : stat->max;
+        }
+    }
+    return stat->max;
+}
+
+void __not_in_flash_func(probe_trace)(uint8_t event, uint16_t arg)
+{
+    // O laço e as IRQs do mesmo núcleo escrevem no mesmo anel
+    uint32_t irq = save_and_disable_interrupts();
+    uint core = get_core_num();
+    uint32_t head = trace_head[core];
+    probe_event_t *entry = &trace[core][head & (PROBE_TRACE_SIZE - 1)];
+    entry->time_us = hal_time_us();
+    entry->arg = arg;
+    entry->event = event;
+    entry->core = core;
+    trace_head[core] = head + 1;
+    restore_interrupts(irq);
+}
+
+uint probe_trace_collect(probe_event_t *out, uint max)
+{
+    // Janela de cada núcleo: os últimos PROBE_TRACE_SIZE eventos
+    uint32_t next[PROBE_CORES], end[PROBE_CORES];
+    for (uint core = 0; core < PROBE_CORES; core++)
+    {
+        end[core] = trace_head[core];
+        next[core] = end[core] > PROBE_TRACE_SIZE ? end[core] - PROBE_TRACE_SIZE : 0;
+    }
+
+    // Intercala pelos instantes; cada anel já está em ordem
+    uint count = 0;
+    while (count < max)
+    {
+        int pick = -1;
+        for (uint core = 0; core < PROBE_CORES; core++)
+        {
+            if (next[core] == end[core])
+                continue;
+            const probe_event_t *entry = &trace[core][next[core] & (PROBE_TRACE_SIZE - 1)];
+            if (pick < 0 ||
+                (int32_t)(entry->time_us - trace[pick][next[pick] & (PROBE_TRACE_SIZE - 1)].time_us) < 0)
+                pick = core;
+        }
+        if (pick < 0)
+            break;
+        out[count++] = trace[pick][next[pick]++ & (PROBE_TRACE_SIZE - 1)];
+    }
+    return count;
+}
@@ -0,0 +1,83 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include "pico/stdlib.h"
+#include "hal.h"
+
+// Instrumentação sempre ligada dos caminhos quentes.
+//
+// Cada seção medida acumula mínimo, máximo, soma e um histograma em
+// potências de 2 num probe_stat_t; quem mede define a unidade (ciclos de
+// hal_cycles() ou microssegundos). PROBE_BEGIN/PROBE_END custam uma leitura
+// do SysTick cada; o registro é um punhado de somas e comparações.
+// Além disso, um anel por núcleo guarda os últimos eventos com o instante em
+// microssegundos, para reconstruir a ordem do que aconteceu.
+//
+// Cada probe_stat_t tem um só escritor (o laço ou uma IRQ), de modo que nada
+// trava; o anel de cada núcleo fica com as IRQs desligadas por poucas
+// instruções. A leitura pela interface pode pegar um registro pela metade, o
+// que só afeta o diagnóstico.
+//
+// Com PROBE_ENABLED 0 (target_compile_definitions) as macros somem do código.
+
+#ifndef PROBE_ENABLED
+#define PROBE_ENABLED 1
+#endif
+
+#define PROBE_HIST_BINS 24    // Faixa k >= 1: [2^(k-1), 2^k); a última acumula o resto
+#define PROBE_TRACE_SIZE 128  // Eventos por núcleo (potência de 2)
+
+typedef struct
+{
+    uint32_t count;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint32_t hist[PROBE_HIST_BINS];
+} probe_stat_t;
+
+typedef struct
+{
+    uint32_t time_us;
+    uint16_t arg;
+    uint8_t event;
+    uint8_t core;
+} probe_event_t;
+
+void probe_reset(probe_stat_t *stat);
+void probe_record(probe_stat_t *stat, uint32_t value);
+uint32_t probe_mean(const probe_stat_t *stat);
+
+// Registra o desvio, em us, entre o intervalo desde a última chamada (em
+// *last_us) e `expected_us`; com 0 registra o próprio intervalo
+void probe_interval(probe_stat_t *stat, uint32_t *last_us, uint32_t expected_us);
+
+// Limite superior da faixa do histograma que contém a fração `permille` das
+// medidas (ex: 990 para o p99)
+uint32_t probe_percentile(const probe_stat_t *stat, uint16_t permille);
+
+void probe_trace(uint8_t event, uint16_t arg);
+
+// Copia até `max` eventos dos dois núcleos, do mais antigo ao mais recente
+uint probe_trace_collect(probe_event_t *out, uint max);
+
+#if PROBE_ENABLED
+#define PROBE_BEGIN(name) const uint32_t name = hal_cycles()
+#define PROBE_END(stat, name) probe_record((stat), (hal_cycles() - (name)) & HAL_CYCLES_MASK)
+#define PROBE_VALUE(stat, value) probe_record((stat), (value))
+#define PROBE_INTERVAL(stat, expected_us)                      \
+    do                                                         \
+    {                                                          \
+        static uint32_t probe_last_us;                         \
+        probe_interval((stat), &probe_last_us, (expected_us)); \
+    } while (0)
+#define PROBE_TRACE(event, arg) probe_trace((event), (arg))
+#else
+#define PROBE_BEGIN(name) ((void)0)
+#define PROBE_END(stat, name) ((void)0)
+#define PROBE_VALUE(stat, value) ((void)0)
+#define PROBE_INTERVAL(stat, expected_us) ((void)0)
+#define PROBE_TRACE(event, arg) ((void)0)
+#endif
+
+#endif // PROBE_H
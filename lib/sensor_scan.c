@@ -0,0 +1,139 @@
+#include "sensor_scan.h"
+#include "adc_sampler.h"
+#include "hardware/adc.h"
+#include "hardware/gpio.h"
+
+#define ADC_INPUT_SETTLE_US 2 // Acomodação do multiplexador interno do ADC
+
+static struct
+{
+    const sensor_channel_t *channels;
+    uint8_t count;
+    const sensor_mux_t *mux;
+    uint oversample_log2;
+    alarm_pool_t *pool;
+    sensor_scan_done_callback_t done;
+
+    volatile bool busy;
+    uint8_t index;           // Canal em medição
+    int8_t current_address;  // Endereço aplicado às linhas de seleção
+    int8_t current_input;    // Entrada usada na última rajada
+    uint32_t start_us;
+} scan;
+
+static sensor_scan_state_t state;
+
+static void sensor_scan_next(void);
+
+static void sensor_scan_burst_done(uint16_t value, void *context)
+{
+    state.latest[scan.index] = value;
+    scan.index++;
+    sensor_scan_next();
+}
+
+static int64_t sensor_scan_settled(alarm_id_t id, void *context)
+{
+    const sensor_channel_t *ch = &scan.channels[scan.index];
+    adc_sampler_burst(ch->adc_input, scan.oversample_log2, sensor_scan_burst_done, NULL);
+    return 0;
+}
+
+static void sensor_scan_set_mux(int8_t address)
+{
+    for (uint8_t bit = 0; bit < scan.mux->select_bits; ++bit)
+        gpio_put(scan.mux->select_pins[bit], (address >> bit) & 1);
+    scan.current_address = address;
+}
+
+// Seleciona o próximo canal ou encerra a varredura
+static void sensor_scan_next(void)
+{
+    if (scan.index >= scan.count)
+    {
+        uint32_t elapsed = time_us_32() - scan.start_us;
+        state.last_scan_us = elapsed;
+        if (elapsed > state.max_scan_us)
+            state.max_scan_us = elapsed;
+        state.scans++;
+        scan.busy = false;
+        if (scan.done)
+            scan.done(&state);
+        return;
+    }
+
+    const sensor_channel_t *ch = &scan.channels[scan.index];
+    uint32_t settle_us = 0;
+    if (ch->mux_address != SENSOR_NO_MUX && ch->mux_address != scan.current_address)
+    {
+        sensor_scan_set_mux(ch->mux_address);
+        settle_us = scan.mux->settle_us;
+    }
+    else if (ch->adc_input != scan.current_input)
+    {
+        settle_us = ADC_INPUT_SETTLE_US;
+    }
+    scan.current_input = ch->adc_input;
+
+    // A acomodação é esperada por um alarme, não em espera ativa na IRQ
+    if (settle_us == 0 || alarm_pool_add_alarm_in_us(scan.pool, settle_us, sensor_scan_settled, NULL, true) < 0)
+        sensor_scan_settled(0, NULL);
+}
+
+void sensor_scan_init(const sensor_channel_t *channels, uint8_t count, const sensor_mux_t *mux,
+                      uint oversample_log2, alarm_pool_t *pool, sensor_scan_done_callback_t done)
+{
+    scan.channels = channels;
+    scan.count = count > SENSOR_MAX_CHANNELS ? SENSOR_MAX_CHANNELS : count;
+    scan.mux = mux;
+    scan.oversample_log2 = oversample_log2;
+    scan.pool = pool;
+    scan.done = done;
+    scan.busy = false;
+    scan.current_address = SENSOR_NO_MUX;
+    scan.current_input = -1;
+
+    for (uint8_t i = 0; i < scan.count; ++i)
+    {
+        adc_gpio_init(26 + channels[i].adc_input);
+        if (channels[i].mux_address != SENSOR_NO_MUX && !mux)
+            panic("Canal %d usa multiplexador nao configurado", i);
+    }
+    if (mux)
+    {
+        for (uint8_t bit = 0; bit < mux->select_bits; ++bit)
+        {
+            gpio_init(mux->select_pins[bit]);
+            gpio_set_dir(mux->select_pins[bit], GPIO_OUT);
+        }
+    }
+}
+
+bool sensor_scan_start(void)
+{
+    if (scan.busy)
+    {
+        state.overruns++;
+        return false;
+    }
+    scan.busy = true;
+    scan.index = 0;
+    scan.start_us = time_us_32();
+    sensor_scan_next();
+    return true;
+}
+
+bool sensor_scan_busy(void)
+{
+    return scan.busy;
+}
+
+uint8_t sensor_scan_channel_count(void)
+{
+    return scan.count;
+}
+
+const sensor_scan_state_t *sensor_scan_state(void)
+{
+    return &state;
+}
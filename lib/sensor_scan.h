@@ -0,0 +1,62 @@
+#ifndef SENSOR_SCAN_H
+#define SENSOR_SCAN_H
+
+#include "pico/stdlib.h"
+
+// Varredura de vários sensores de temperatura.
+//
+// Cada canal é uma entrada do ADC (0 a 2), ligada direto ao sensor ou a um
+// multiplexador analógico cujas linhas de seleção são GPIOs compartilhadas
+// por todas as entradas. A cada período sensor_scan_start() percorre a tabela
+// na ordem dada, aguarda o tempo de acomodação quando o endereço do
+// multiplexador ou a entrada muda, e mede cada canal com uma rajada
+// sobreamostrada do adc_sampler. Todo o encadeamento roda por IRQ (fim do DMA
+// e alarme de acomodação); a CPU fica livre durante a varredura.
+//
+// Dica: agrupe na tabela os canais com o mesmo endereço do multiplexador para
+// pagar o tempo de acomodação uma vez por endereço.
+
+#define SENSOR_MAX_CHANNELS 48 // 3 entradas x multiplexador de 16 vias
+#define SENSOR_MUX_MAX_BITS 4
+#define SENSOR_NO_MUX (-1)
+
+typedef struct
+{
+    uint8_t adc_input;  // Entrada do ADC (0 = GPIO26, 1 = GPIO27, 2 = GPIO28)
+    int8_t mux_address; // Endereço no multiplexador ou SENSOR_NO_MUX
+} sensor_channel_t;
+
+typedef struct
+{
+    uint8_t select_pins[SENSOR_MUX_MAX_BITS]; // GPIOs das linhas de seleção (LSB primeiro)
+    uint8_t select_bits;                      // Quantidade de linhas usadas
+    uint16_t settle_us;                       // Acomodação após trocar o endereço
+} sensor_mux_t;
+
+// Estado por canal em estrutura de vetores: cada campo é um vetor indexado
+// pelo canal, o que mantém juntos os dados percorridos pelos laços da UI
+typedef struct
+{
+    uint16_t latest[SENSOR_MAX_CHANNELS]; // Última leitura, Q12.4
+    uint32_t scans;                       // Varreduras completas
+    uint32_t overruns;                    // Períodos perdidos com varredura em curso
+    uint32_t last_scan_us;                // Duração da última varredura
+    uint32_t max_scan_us;                 // Pior duração observada
+} sensor_scan_state_t;
+
+// Memória de estado da varredura por canal, em bytes
+#define SENSOR_SCAN_BYTES_PER_CHANNEL (sizeof(((sensor_scan_state_t *)0)->latest[0]) + sizeof(sensor_channel_t))
+
+typedef void (*sensor_scan_done_callback_t)(const sensor_scan_state_t *state);
+
+void sensor_scan_init(const sensor_channel_t *channels, uint8_t count, const sensor_mux_t *mux,
+                      uint oversample_log2, alarm_pool_t *pool, sensor_scan_done_callback_t done);
+
+// Inicia uma varredura; retorna falso (e conta um overrun) se a anterior não terminou
+bool sensor_scan_start(void);
+bool sensor_scan_busy(void);
+
+uint8_t sensor_scan_channel_count(void);
+const sensor_scan_state_t *sensor_scan_state(void);
+
+#endif // SENSOR_SCAN_H
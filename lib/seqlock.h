@@ -0,0 +1,52 @@
+#ifndef SEQLOCK_H
+#define SEQLOCK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Seqlock para publicar estruturas de um único escritor para vários leitores
+// (outro núcleo ou IRQ) sem desabilitar interrupções.
+//
+// O escritor deixa o contador ímpar durante a atualização; o leitor copia os
+// dados e repete a cópia se o contador mudou ou estava ímpar. O escritor nunca
+// espera, e uma cópia só é aceita se nenhum byte foi alterado no meio dela.
+//
+//   seqlock_write_begin(&lock);  ...altera os dados...  seqlock_write_end(&lock);
+//
+//   uint32_t seq;
+//   do {
+//       seq = seqlock_read_begin(&lock);
+//       ...copia os dados...
+//   } while (seqlock_read_retry(&lock, seq));
+
+typedef struct
+{
+    volatile uint32_t sequence;
+} seqlock_t;
+
+static inline void seqlock_write_begin(seqlock_t *lock)
+{
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+static inline void seqlock_write_end(seqlock_t *lock)
+{
+    __atomic_store_n(&lock->sequence, lock->sequence + 1, __ATOMIC_RELEASE);
+}
+
+static inline uint32_t seqlock_read_begin(const seqlock_t *lock)
+{
+    uint32_t seq;
+    while ((seq = __atomic_load_n(&lock->sequence, __ATOMIC_ACQUIRE)) & 1)
+        ;
+    return seq;
+}
+
+static inline bool seqlock_read_retry(const seqlock_t *lock, uint32_t seq)
+{
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    return __atomic_load_n(&lock->sequence, __ATOMIC_RELAXED) != seq;
+}
+
+#endif // SEQLOCK_H
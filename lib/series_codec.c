@@ -0,0 +1,161 @@
+#include "series_codec.h"
+#include <string.h>
+
+#define RAW_BITS 16
+
+typedef struct
+{
+    uint8_t prefix;      // Valor do prefixo, lido da esquerda para a direita
+    uint8_t prefix_bits;
+    uint8_t value_bits;
+} series_bucket_t;
+
+static const series_bucket_t buckets[] = {
+    {0x0, 1, 0},
+    {0x2, 2, 3},
+    {0x6, 3, 6},
+    {0xE, 4, 9},
+    {0xF, 4, 17},
+};
+#define BUCKET_COUNT (sizeof(buckets) / sizeof(buckets[0]))
+
+static unsigned bucket_for(int32_t delta)
+{
+    if (delta == 0)
+        return 0;
+    for (unsigned i = 1; i < BUCKET_COUNT - 1; i++)
+    {
+        int32_t limit = 1 << (buckets[i].value_bits - 1);
+        if (delta >= -limit && delta < limit)
+            return i;
+    }
+    return BUCKET_COUNT - 1;
+}
+
+static void put_bits(uint8_t *buffer, uint32_t *bit, uint32_t value, unsigned bits)
+{
+    while (bits--)
+    {
+        uint8_t mask = 0x80 >> (*bit & 7);
+        if ((value >> bits) & 1)
+            buffer[*bit >> 3] |= mask;
+        else
+            buffer[*bit >> 3] &= ~mask;
+        (*bit)++;
+    }
+}
+
+static uint32_t get_bits(const uint8_t *buffer, uint32_t *bit, unsigned bits)
+{
+    uint32_t value = 0;
+    while (bits--)
+    {
+        value = (value << 1) | ((buffer[*bit >> 3] >> (7 - (*bit & 7))) & 1);
+        (*bit)++;
+    }
+    return value;
+}
+
+// Estende o sinal de um campo de `bits` bits
+static inline int32_t sign_extend(uint32_t value, unsigned bits)
+{
+    uint32_t sign = 1u << (bits - 1);
+    return (int32_t)((value ^ sign) - sign);
+}
+
+static void series_state_init(series_state_t *state, uint8_t fields)
+{
+    memset(state, 0, sizeof(*state));
+    state->fields = fields < SERIES_CODEC_MAX_FIELDS ? fields : SERIES_CODEC_MAX_FIELDS;
+}
+
+void series_encoder_init(series_encoder_t *encoder, uint8_t *buffer, uint16_t size, uint8_t fields)
+{
+    encoder->buffer = buffer;
+    encoder->size_bits = (uint32_t)size * 8;
+    encoder->bit = 0;
+    encoder->count = 0;
+    series_state_init(&encoder->state, fields);
+}
+
+bool series_encoder_add(series_encoder_t *encoder, const int16_t *values)
+{
+    series_state_t *state = &encoder->state;
+
+    // Primeiro passo só mede: o registro entra inteiro ou não entra
+    uint32_t bits = 0;
+    for (unsigned i = 0; i < state->fields; i++)
+    {
+        if (encoder->count == 0)
+        {
+            bits += RAW_BITS;
+            continue;
+        }
+        const series_bucket_t *bucket =
+            &buckets[bucket_for(values[i] - state->previous[i])];
+        bits += bucket->prefix_bits + bucket->value_bits;
+    }
+    if (encoder->bit + bits > encoder->size_bits)
+        return false;
+
+    for (unsigned i = 0; i < state->fields; i++)
+    {
+        if (encoder->count == 0)
+        {
+            put_bits(encoder->buffer, &encoder->bit, (uint16_t)values[i], RAW_BITS);
+        }
+        else
+        {
+            int32_t delta = values[i] - state->previous[i];
+            const series_bucket_t *bucket = &buckets[bucket_for(delta)];
+            put_bits(encoder->buffer, &encoder->bit, bucket->prefix, bucket->prefix_bits);
+            if (bucket->value_bits)
+                put_bits(encoder->buffer, &encoder->bit, (uint32_t)delta, bucket->value_bits);
+        }
+        state->previous[i] = values[i];
+    }
+    encoder->count++;
+    return true;
+}
+
+void series_decoder_init(series_decoder_t *decoder, const uint8_t *buffer, uint8_t fields,
+                         uint16_t count)
+{
+    decoder->buffer = buffer;
+    decoder->bit = 0;
+    decoder->remaining = count;
+    decoder->position = 0;
+    series_state_init(&decoder->state, fields);
+}
+
+bool series_decoder_next(series_decoder_t *decoder, int16_t *values)
+{
+    series_state_t *state = &decoder->state;
+    if (decoder->remaining == 0)
+        return false;
+
+    for (unsigned i = 0; i < state->fields; i++)
+    {
+        if (decoder->position == 0)
+        {
+            values[i] = (int16_t)get_bits(decoder->buffer, &decoder->bit, RAW_BITS);
+        }
+        else
+        {
+            // Prefixo unário: conta os 1 até o 0 ou até o maior balde
+            unsigned index = 0;
+            while (index < BUCKET_COUNT - 1 && get_bits(decoder->buffer, &decoder->bit, 1))
+                index++;
+            const series_bucket_t *bucket = &buckets[index];
+            int32_t delta = 0;
+            if (bucket->value_bits)
+                delta = sign_extend(get_bits(decoder->buffer, &decoder->bit, bucket->value_bits),
+                                    bucket->value_bits);
+            values[i] = (int16_t)(state->previous[i] + delta);
+        }
+        state->previous[i] = values[i];
+    }
+    decoder->position++;
+    decoder->remaining--;
+    return true;
+}
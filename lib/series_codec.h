@@ -0,0 +1,64 @@
+#ifndef SERIES_CODEC_H
+#define SERIES_CODEC_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Compressão de séries de registros com campos int16 amostrados a intervalo
+// fixo. O tempo é implícito: no Gorilla seria o delta-of-delta do timestamp,
+// aqui sempre zero e sem nenhum bit gravado.
+//
+// O primeiro registro do bloco vai cru (16 bits por campo); nos seguintes cada
+// campo grava a diferença para o registro anterior, com prefixo de tamanho
+// variável:
+//
+//   0                      delta = 0
+//   10   + 3 bits          delta em [-4, 3]
+//   110  + 6 bits          delta em [-32, 31]
+//   1110 + 9 bits          delta em [-256, 255]
+//   1111 + 17 bits         qualquer outro
+//
+// Delta simples e não delta-of-delta: com o ruído da leitura o segundo dobra
+// a amplitude e custa mais bits. Temperaturas que variam devagar ficam em 1 a
+// 5 bits por campo (3,5 a 4x menos que int16). Cada bloco é independente; o
+// decodificador anda registro a registro sobre o próprio bloco, sem
+// descomprimir tudo para a RAM.
+
+#define SERIES_CODEC_MAX_FIELDS 48
+
+typedef struct
+{
+    uint8_t fields;
+    int16_t previous[SERIES_CODEC_MAX_FIELDS];
+} series_state_t;
+
+typedef struct
+{
+    uint8_t *buffer;
+    uint32_t size_bits;
+    uint32_t bit;   // Bits usados
+    uint16_t count; // Registros no bloco
+    series_state_t state;
+} series_encoder_t;
+
+typedef struct
+{
+    const uint8_t *buffer;
+    uint32_t bit;
+    uint16_t remaining;
+    uint16_t position; // Registros já lidos
+    series_state_t state;
+} series_decoder_t;
+
+void series_encoder_init(series_encoder_t *encoder, uint8_t *buffer, uint16_t size, uint8_t fields);
+
+// Acrescenta um registro; falso (e nada muda) se ele não cabe no bloco
+bool series_encoder_add(series_encoder_t *encoder, const int16_t *values);
+
+void series_decoder_init(series_decoder_t *decoder, const uint8_t *buffer, uint8_t fields,
+                         uint16_t count);
+
+// Próximo registro do bloco; falso no fim
+bool series_decoder_next(series_decoder_t *decoder, int16_t *values);
+
+#endif // SERIES_CODEC_H
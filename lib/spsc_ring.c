@@ -0,0 +1,46 @@
+#include <string.h>
+#include "spsc_ring.h"
+
+void spsc_ring_init(spsc_ring_t *ring, void *buffer, uint16_t element_size, uint16_t capacity)
+{
+    ring->buffer = buffer;
+    ring->element_size = element_size;
+    ring->capacity = capacity;
+    ring->head = 0;
+    ring->tail = 0;
+    ring->dropped = 0;
+}
+
+bool spsc_ring_push(spsc_ring_t *ring, const void *element)
+{
+    uint32_t head = ring->head;
+    uint32_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    if (head - tail >= ring->capacity)
+    {
+        ring->dropped++;
+        return false;
+    }
+
+    memcpy(&ring->buffer[(head & (ring->capacity - 1)) * ring->element_size], element, ring->element_size);
+    // Publica o elemento só depois que ele está completo no buffer
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool spsc_ring_pop(spsc_ring_t *ring, void *element)
+{
+    uint32_t tail = ring->tail;
+    uint32_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    if (head == tail)
+        return false;
+
+    memcpy(element, &ring->buffer[(tail & (ring->capacity - 1)) * ring->element_size], ring->element_size);
+    // Libera a posição para o produtor só depois da cópia
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t spsc_ring_count(const spsc_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) - __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
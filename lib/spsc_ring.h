@@ -0,0 +1,37 @@
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Fila circular de um produtor e um consumidor, sem travas.
+//
+// Cada lado escreve apenas o seu índice (head pelo produtor, tail pelo
+// consumidor) e lê o do outro com semântica acquire; a publicação usa release,
+// de modo que o consumidor nunca enxerga um elemento pela metade. Produtor e
+// consumidor podem estar em núcleos diferentes ou em IRQ e laço principal.
+// A capacidade precisa ser potência de 2; os índices são contadores livres.
+
+typedef struct
+{
+    uint8_t *buffer;
+    uint16_t element_size;
+    uint16_t capacity;
+    uint32_t head; // Escrito só pelo produtor
+    uint32_t tail; // Escrito só pelo consumidor
+    uint32_t dropped; // Elementos recusados por fila cheia (produtor)
+} spsc_ring_t;
+
+void spsc_ring_init(spsc_ring_t *ring, void *buffer, uint16_t element_size, uint16_t capacity);
+
+// Produtor: copia o elemento para a fila; falso se estiver cheia
+bool spsc_ring_push(spsc_ring_t *ring, const void *element);
+
+// Consumidor: retira o elemento mais antigo; falso se estiver vazia
+bool spsc_ring_pop(spsc_ring_t *ring, void *element);
+
+// Elementos disponíveis (vista aproximada para qualquer um dos lados)
+uint32_t spsc_ring_count(const spsc_ring_t *ring);
+
+#endif // SPSC_RING_H
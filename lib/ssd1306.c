@@ -1,5 +1,19 @@
+#include <string.h>
 #include "ssd1306.h"
 #include "font.h"
+#include "hardware/irq.h"
+
+// Dono de cada canal DMA usado por um display, consultado no handler da IRQ
+static ssd1306_t *dma_owner[NUM_DMA_CHANNELS];
+
+static void ssd1306_clear_dirty(ssd1306_t *ssd)
+{
+  for (uint8_t page = 0; page < SSD1306_MAX_PAGES; ++page)
+  {
+    ssd->dirty_x0[page] = 0xFF;
+    ssd->dirty_x1[page] = 0;
+  }
+}
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c)
 {
@@ -9,9 +23,23 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  // Desloca o buffer em 3 bytes para que os dados (a partir do índice 1)
+  // fiquem alinhados em 32 bits: cada coluna de 8 páginas vira 2 palavras
+  ssd->ram_buffer = (uint8_t *)calloc(ssd->bufsize + 3, sizeof(uint8_t)) + 3;
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
+  ssd->shadow_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  // Pior caso: uma janela por página, cada uma com 8 bytes de comando e
+  // 1 byte de controle antes dos dados
+  ssd->tx_stream = calloc(ssd->pages * (ssd->width + 9), sizeof(uint16_t));
+  ssd->tx_len = 0;
+  ssd->dma_channel = -1;
+  ssd->flush_callback = NULL;
+  ssd->flush_context = NULL;
+  ssd->last_flush_bytes = 0;
+  ssd1306_clear_dirty(ssd);
+  // A RAM do display tem conteúdo indefinido após o reset
+  ssd->full_refresh = true;
 }
 
 void ssd1306_config(ssd1306_t *ssd)
@@ -45,6 +73,7 @@ void ssd1306_config(ssd1306_t *ssd)
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command)
 {
+  ssd1306_flush_wait(ssd);
   ssd->port_buffer[1] = command;
   i2c_write_blocking(
       ssd->i2c_port,
@@ -54,78 +83,332 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command)
       false);
 }
 
+// Marca como alterada a janela [x0, x1] x [page0, page1]
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+  if (page1 >= ssd->pages)
+    page1 = ssd->pages - 1;
+  for (uint8_t page = page0; page <= page1; ++page)
+  {
+    if (x0 < ssd->dirty_x0[page])
+      ssd->dirty_x0[page] = x0;
+    if (x1 > ssd->dirty_x1[page])
+      ssd->dirty_x1[page] = x1;
+  }
+}
+
+// Força o reenvio do quadro completo no próximo flush
+void ssd1306_invalidate(ssd1306_t *ssd)
+{
+  ssd->full_refresh = true;
+}
+
+// Acrescenta uma transação I2C ao stream; o último byte leva o bit de STOP
+static inline void ssd1306_stream_byte(ssd1306_t *ssd, uint8_t byte, bool last)
+{
+  ssd->tx_stream[ssd->tx_len++] = byte | (last ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+}
+
+// Monta uma janela retangular do buffer (modo de endereçamento vertical)
+static void ssd1306_send_window(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1)
+{
+  const uint8_t commands[] = {0x00, SET_COL_ADDR, x0, x1, SET_PAGE_ADDR, page0, page1};
+  for (uint8_t i = 0; i < sizeof(commands); ++i)
+    ssd1306_stream_byte(ssd, commands[i], i == sizeof(commands) - 1);
+
+  // No modo vertical o display percorre as páginas de cada coluna antes de
+  // avançar para a próxima, a mesma ordem do ram_buffer
+  ssd1306_stream_byte(ssd, 0x40, false);
+  for (uint16_t x = x0; x <= x1; ++x)
+  {
+    uint16_t index = (x << 3) + page0 + 1;
+    for (uint8_t page = page0; page <= page1; ++page, ++index)
+    {
+      ssd1306_stream_byte(ssd, ssd->ram_buffer[index], x == x1 && page == page1);
+      ssd->shadow_buffer[index] = ssd->ram_buffer[index];
+    }
+  }
+  ssd->last_flush_bytes += (x1 - x0 + 1) * (page1 - page0 + 1);
+}
+
+static void __isr ssd1306_dma_irq_handler(void)
+{
+  for (uint ch = 0; ch < NUM_DMA_CHANNELS; ++ch)
+  {
+    ssd1306_t *ssd = dma_owner[ch];
+    if (ssd && dma_channel_get_irq0_status(ch))
+    {
+      dma_channel_acknowledge_irq0(ch);
+      if (ssd->flush_callback)
+        ssd->flush_callback(ssd->flush_context);
+    }
+  }
+}
+
+// Reserva um canal DMA para alimentar o FIFO de TX do I2C
+void ssd1306_dma_init(ssd1306_t *ssd)
+{
+  ssd->dma_channel = dma_claim_unused_channel(true);
+  dma_owner[ssd->dma_channel] = ssd;
+
+  irq_add_shared_handler(DMA_IRQ_0, ssd1306_dma_irq_handler, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+  dma_channel_set_irq0_enabled(ssd->dma_channel, true);
+  irq_set_enabled(DMA_IRQ_0, true);
+}
+
+void ssd1306_set_flush_callback(ssd1306_t *ssd, ssd1306_flush_callback_t callback, void *context)
+{
+  ssd->flush_callback = callback;
+  ssd->flush_context = context;
+}
+
+// Verdadeiro enquanto o quadro anterior ainda está sendo transmitido
+bool ssd1306_flush_busy(ssd1306_t *ssd)
+{
+  if (ssd->dma_channel >= 0 && dma_channel_is_busy(ssd->dma_channel))
+    return true;
+
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  if (hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+    return false;
+  return !(hw->status & I2C_IC_STATUS_TFE_BITS) || (hw->status & I2C_IC_STATUS_ACTIVITY_BITS);
+}
+
+void ssd1306_flush_wait(ssd1306_t *ssd)
+{
+  while (ssd1306_flush_busy(ssd))
+    tight_loop_contents();
+}
+
+// Entrega o stream montado ao controlador I2C, por DMA ou por polling
+static void ssd1306_start_stream(ssd1306_t *ssd)
+{
+  i2c_hw_t *hw = i2c_get_hw(ssd->i2c_port);
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  (void)hw->clr_tx_abrt;
+
+  if (ssd->dma_channel < 0)
+  {
+    for (size_t i = 0; i < ssd->tx_len; ++i)
+    {
+      while (!i2c_get_write_available(ssd->i2c_port))
+        tight_loop_contents();
+      hw->data_cmd = ssd->tx_stream[i];
+    }
+    if (ssd->flush_callback)
+      ssd->flush_callback(ssd->flush_context);
+    return;
+  }
+
+  dma_channel_config config = dma_channel_get_default_config(ssd->dma_channel);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_16);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_dreq(&config, i2c_get_dreq(ssd->i2c_port, true));
+  dma_channel_configure(ssd->dma_channel, &config, &hw->data_cmd, ssd->tx_stream, ssd->tx_len, true);
+}
+
+// Inicia o envio das regiões alteradas e retorna sem esperar o barramento.
+// O ram_buffer fica livre para o próximo quadro assim que a função retorna;
+// o quadro em trânsito vive em tx_stream. Retorna falso se nada mudou.
+bool ssd1306_send_data_async(ssd1306_t *ssd)
+{
+  // O stream só pode ser reescrito depois que o DMA terminar de lê-lo
+  ssd1306_flush_wait(ssd);
+
+  bool force = ssd->full_refresh;
+  if (force)
+  {
+    ssd1306_mark_dirty(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+    ssd->full_refresh = false;
+  }
+
+  // Descarta as bordas da região suja que não mudaram desde o último envio
+  if (!force)
+  {
+    for (uint8_t page = 0; page < ssd->pages; ++page)
+    {
+      uint8_t x0 = ssd->dirty_x0[page];
+      uint8_t x1 = ssd->dirty_x1[page];
+      while (x0 <= x1 && ssd->ram_buffer[(x0 << 3) + page + 1] == ssd->shadow_buffer[(x0 << 3) + page + 1])
+        ++x0;
+      while (x1 > x0 && ssd->ram_buffer[(x1 << 3) + page + 1] == ssd->shadow_buffer[(x1 << 3) + page + 1])
+        --x1;
+      if (x0 > x1)
+      {
+        x0 = 0xFF;
+        x1 = 0;
+      }
+      ssd->dirty_x0[page] = x0;
+      ssd->dirty_x1[page] = x1;
+    }
+  }
+
+  // Agrupa páginas vizinhas numa mesma janela quando isso custa menos bytes
+  // do que abrir uma janela nova
+  ssd->last_flush_bytes = 0;
+  ssd->tx_len = 0;
+  int16_t win_page0 = -1;
+  uint8_t win_page1 = 0, win_x0 = 0, win_x1 = 0;
+  for (uint8_t page = 0; page < ssd->pages; ++page)
+  {
+    uint8_t x0 = ssd->dirty_x0[page];
+    uint8_t x1 = ssd->dirty_x1[page];
+    if (x0 > x1)
+      continue;
+
+    if (win_page0 >= 0)
+    {
+      uint8_t mx0 = x0 < win_x0 ? x0 : win_x0;
+      uint8_t mx1 = x1 > win_x1 ? x1 : win_x1;
+      uint32_t merged = (uint32_t)(page - win_page0 + 1) * (mx1 - mx0 + 1);
+      uint32_t split = (uint32_t)(win_page1 - win_page0 + 1) * (win_x1 - win_x0 + 1) +
+                       (x1 - x0 + 1) + SSD1306_WINDOW_OVERHEAD;
+      if (merged <= split)
+      {
+        win_page1 = page;
+        win_x0 = mx0;
+        win_x1 = mx1;
+        continue;
+      }
+      ssd1306_send_window(ssd, win_x0, win_x1, win_page0, win_page1);
+    }
+    win_page0 = page;
+    win_page1 = page;
+    win_x0 = x0;
+    win_x1 = x1;
+  }
+  if (win_page0 >= 0)
+    ssd1306_send_window(ssd, win_x0, win_x1, win_page0, win_page1);
+
+  ssd1306_clear_dirty(ssd);
+  if (ssd->tx_len == 0)
+    return false;
+  ssd1306_start_stream(ssd);
+  return true;
+}
+
 void ssd1306_send_data(ssd1306_t *ssd)
 {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-      ssd->i2c_port,
-      ssd->address,
-      ssd->ram_buffer,
-      ssd->bufsize,
-      false);
+  ssd1306_send_data_async(ssd);
+  ssd1306_flush_wait(ssd);
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value)
 {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint8_t page = y >> 3;
+  uint16_t index = page + (x << 3) + 1;
   uint8_t pixel = (y & 0b111);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
   else
     ssd->ram_buffer[index] &= ~(1 << pixel);
+
+  // Registra a coluna alterada na página correspondente
+  if (x < ssd->dirty_x0[page])
+    ssd->dirty_x0[page] = x;
+  if (x > ssd->dirty_x1[page])
+    ssd->dirty_x1[page] = x;
 }
 
-/*
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-  uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
+// Aplica o valor aos bits [y0, y1] de uma coluna (8 páginas contíguas)
+static inline void ssd1306_column_span(uint8_t *column, uint8_t y0, uint8_t y1, bool value)
+{
+  uint8_t page0 = y0 >> 3;
+  uint8_t page1 = y1 >> 3;
+  uint8_t mask0 = 0xFF << (y0 & 7);
+  uint8_t mask1 = 0xFF >> (7 - (y1 & 7));
+
+  if (page0 == page1)
+    mask0 &= mask1;
+  if (value)
+    column[page0] |= mask0;
+  else
+    column[page0] &= ~mask0;
+  if (page0 == page1)
+    return;
+
+  for (uint8_t page = page0 + 1; page < page1; ++page)
+    column[page] = value ? 0xFF : 0x00;
+  if (value)
+    column[page1] |= mask1;
+  else
+    column[page1] &= ~mask1;
+}
 
 void ssd1306_fill(ssd1306_t *ssd, bool value)
 {
-  // Itera por todas as posições do display
-  for (uint8_t y = 0; y < ssd->height; ++y)
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, ssd->width - 1, 0, ssd->pages - 1);
+}
+
+// Preenche o retângulo coluna a coluna; colunas de altura total viram
+// duas escritas de 32 bits
+void ssd1306_fill_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value)
+{
+  if (width == 0 || height == 0 || left >= ssd->width || top >= ssd->height)
+    return;
+  uint8_t right = (left + width > ssd->width) ? ssd->width - 1 : left + width - 1;
+  uint8_t bottom = (top + height > ssd->height) ? ssd->height - 1 : top + height - 1;
+  bool full_column = (top == 0 && bottom == ssd->height - 1 && ssd->pages == SSD1306_MAX_PAGES);
+  uint32_t word = value ? 0xFFFFFFFFu : 0;
+
+  for (uint16_t x = left; x <= right; ++x)
   {
-    for (uint8_t x = 0; x < ssd->width; ++x)
+    uint8_t *column = &ssd->ram_buffer[(x << 3) + 1];
+    if (full_column)
+    {
+      ((uint32_t *)column)[0] = word;
+      ((uint32_t *)column)[1] = word;
+    }
+    else
     {
-      ssd1306_pixel(ssd, x, y, value);
+      ssd1306_column_span(column, top, bottom, value);
     }
   }
+  ssd1306_mark_dirty(ssd, left, right, top >> 3, bottom >> 3);
 }
 
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill)
 {
-  for (uint8_t x = left; x < left + width; ++x)
+  // As bordas seguem a mesma aritmética de 8 bits da versão pixel a pixel
+  uint8_t right = left + width - 1;
+  uint8_t bottom = top + height - 1;
+  if (width > 0)
   {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+    ssd1306_hline(ssd, left, right, top, value);
+    ssd1306_hline(ssd, left, right, bottom, value);
   }
-  for (uint8_t y = top; y < top + height; ++y)
+  if (height > 0)
   {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+    ssd1306_vline(ssd, left, top, bottom, value);
+    ssd1306_vline(ssd, right, top, bottom, value);
   }
 
-  if (fill)
-  {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x)
-    {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y)
-      {
-        ssd1306_pixel(ssd, x, y, value);
-      }
-    }
-  }
+  if (fill && width > 2 && height > 2)
+    ssd1306_fill_rect(ssd, top + 1, left + 1, width - 2, height - 2, value);
 }
 
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value)
 {
+  // Linhas horizontais e verticais usam os caminhos por byte
+  if (y0 == y1)
+  {
+    ssd1306_hline(ssd, x0 < x1 ? x0 : x1, x0 < x1 ? x1 : x0, y0, value);
+    return;
+  }
+  if (x0 == x1)
+  {
+    ssd1306_vline(ssd, x0, y0 < y1 ? y0 : y1, y0 < y1 ? y1 : y0, value);
+    return;
+  }
+
   int dx = abs(x1 - x0);
   int dy = abs(y1 - y0);
 
@@ -159,45 +442,70 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value)
 {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  if (x0 > x1 || x0 >= ssd->width || y >= ssd->height)
+    return;
+  if (x1 >= ssd->width)
+    x1 = ssd->width - 1;
+
+  // Um bit por coluna; colunas consecutivas estão a 8 bytes de distância
+  uint8_t mask = 1 << (y & 7);
+  uint8_t *byte = &ssd->ram_buffer[(x0 << 3) + (y >> 3) + 1];
+  for (uint16_t x = x0; x <= x1; ++x, byte += 8)
+  {
+    if (value)
+      *byte |= mask;
+    else
+      *byte &= ~mask;
+  }
+  ssd1306_mark_dirty(ssd, x0, x1, y >> 3, y >> 3);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value)
 {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  if (y0 > y1 || x >= ssd->width || y0 >= ssd->height)
+    return;
+  if (y1 >= ssd->height)
+    y1 = ssd->height - 1;
+
+  ssd1306_column_span(&ssd->ram_buffer[(x << 3) + 1], y0, y1, value);
+  ssd1306_mark_dirty(ssd, x, x, y0 >> 3, y1 >> 3);
+}
+
+// Expande cada bit de um nibble para dois bits (escala 2x na vertical)
+static const uint8_t nibble_expand[16] = {
+    0x00, 0x03, 0x0C, 0x0F, 0x30, 0x33, 0x3C, 0x3F,
+    0xC0, 0xC3, 0xCC, 0xCF, 0xF0, 0xF3, 0xFC, 0xFF};
+
+static inline const uint8_t *ssd1306_glyph(char c)
+{
+  uint8_t code = (uint8_t)c;
+  return &font[(code < 128 ? font_glyph_index[code] : 0) * 8];
 }
 
 // Função para desenhar um caractere
+// Cada byte do glifo já é uma coluna de 8 pixels no formato do buffer, então
+// basta deslocá-lo para a linha y e mesclá-lo em uma ou duas páginas
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
-  char ver = c;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  }
-  else if (c >= '0' && c <= '9')
-  {
-    index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
-  }
-  else if (c >= 'a' && c <= 'z')
-  {
-    index = (c - 'a' + 37) * 8;
-  }
-  else if (c >= '!' && c <= '@')
-  {
-    index = (c - '>' + 67 + 25) * 8; // Posição do símbolo '>' na fonte
-  }
-  for (uint8_t i = 0; i < 8; ++i)
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  const uint8_t *glyph = ssd1306_glyph(c);
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  bool two_pages = shift && (page + 1 < ssd->pages);
+  uint8_t mask_lo = 0xFF << shift;
+  uint8_t mask_hi = 0xFF >> (8 - shift);
+  uint8_t last = (x + 7 < ssd->width) ? x + 7 : ssd->width - 1;
+
+  for (uint16_t col = x; col <= last; ++col)
   {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
-    {
-      ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-    }
+    uint8_t line = *glyph++;
+    uint8_t *column = &ssd->ram_buffer[(col << 3) + 1];
+    column[page] = (column[page] & ~mask_lo) | (uint8_t)(line << shift);
+    if (two_pages)
+      column[page + 1] = (column[page + 1] & ~mask_hi) | (line >> (8 - shift));
   }
+  ssd1306_mark_dirty(ssd, x, last, page, two_pages ? page + 1 : page);
 }
 
 // Função para desenhar uma string
@@ -219,40 +527,33 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
   }
 }
 
+// Desenha o glifo em escala 2x: cada coluna vira 16 pixels pela tabela de
+// nibbles e é escrita duas vezes, cobrindo até três páginas
 void ssd1306_draw_char_large(ssd1306_t *ssd, char c, uint8_t x, uint8_t y)
 {
-  uint16_t index = 0;
-  char ver = c;
-  if (c >= 'A' && c <= 'Z')
-  {
-    index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  }
-  else if (c >= '0' && c <= '9')
-  {
-    index = (c - '0' + 1) * 8; // Adiciona o deslocamento necessário
-  }
-  else if (c >= 'a' && c <= 'z')
-  {
-    index = (c - 'a' + 37) * 8;
-  }
-  else if (c == '>')
-  {
-    index = c - '>' + 62 * 7; // Posição do símbolo '>' na fonte
-  }
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  const uint8_t *glyph = ssd1306_glyph(c);
+  uint8_t page = y >> 3;
+  uint8_t shift = y & 7;
+  uint32_t mask = 0xFFFFu << shift;
+  uint8_t last_page = (y + 15) >> 3;
+  if (last_page >= ssd->pages)
+    last_page = ssd->pages - 1;
+  uint8_t last = (x + 15 < ssd->width) ? x + 15 : ssd->width - 1;
 
-  for (uint8_t i = 0; i < 8; ++i)
+  for (uint16_t col = x; col <= last; ++col)
   {
-    uint8_t line = font[index + i];
-    for (uint8_t j = 0; j < 8; ++j)
+    uint8_t line = glyph[(col - x) >> 1];
+    uint32_t bits = (uint32_t)(nibble_expand[line & 0x0F] | (nibble_expand[line >> 4] << 8)) << shift;
+    uint8_t *column = &ssd->ram_buffer[(col << 3) + 1];
+    for (uint8_t p = page, k = 0; p <= last_page; ++p, k += 8)
     {
-      bool pixel_on = line & (1 << j);
-      // Expande cada pixel para um bloco 2x2
-      ssd1306_pixel(ssd, x + (i * 2), y + (j * 2), pixel_on);
-      ssd1306_pixel(ssd, x + (i * 2) + 1, y + (j * 2), pixel_on);
-      ssd1306_pixel(ssd, x + (i * 2), y + (j * 2) + 1, pixel_on);
-      ssd1306_pixel(ssd, x + (i * 2) + 1, y + (j * 2) + 1, pixel_on);
+      uint8_t m = mask >> k;
+      column[p] = (column[p] & ~m) | (uint8_t)(bits >> k);
     }
   }
+  ssd1306_mark_dirty(ssd, x, last, page, last_page);
 }
 
 void ssd1306_draw_string_large(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y)
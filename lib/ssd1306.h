@@ -4,9 +4,12 @@
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
+#include "hardware/dma.h"
 
 #define WIDTH 128
 #define HEIGHT 64
+#define SSD1306_MAX_PAGES 8         // Máximo de páginas (64 linhas / 8)
+#define SSD1306_WINDOW_OVERHEAD 12  // Bytes extras no barramento por janela enviada
 
 typedef enum
 {
@@ -29,6 +32,8 @@ typedef enum
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef void (*ssd1306_flush_callback_t)(void *context);
+
 typedef struct
 {
   uint8_t width, height, pages, address;
@@ -37,15 +42,33 @@ typedef struct
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t *shadow_buffer;                // Cópia do último quadro enviado ao display
+  uint16_t *tx_stream;                   // Quadro em trânsito, no formato do IC_DATA_CMD
+  size_t tx_len;                         // Palavras válidas em tx_stream
+  int dma_channel;                       // Canal DMA do envio (-1 = envio por polling)
+  ssd1306_flush_callback_t flush_callback;
+  void *flush_context;
+  uint8_t dirty_x0[SSD1306_MAX_PAGES];   // Primeira coluna alterada em cada página
+  uint8_t dirty_x1[SSD1306_MAX_PAGES];   // Última coluna alterada em cada página
+  bool full_refresh;                     // Força o envio do quadro completo
+  size_t last_flush_bytes;               // Bytes de dados enviados no último flush
 } ssd1306_t;
 
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t page0, uint8_t page1);
+void ssd1306_invalidate(ssd1306_t *ssd);
+void ssd1306_dma_init(ssd1306_t *ssd);
+bool ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_flush_busy(ssd1306_t *ssd);
+void ssd1306_flush_wait(ssd1306_t *ssd);
+void ssd1306_set_flush_callback(ssd1306_t *ssd, ssd1306_flush_callback_t callback, void *context);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_fill_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
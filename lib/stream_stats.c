@@ -0,0 +1,188 @@
+#include "stream_stats.h"
+#include <string.h>
+
+#define STATS_SAMPLES_PER_MINUTE 60
+
+static const uint8_t window_slots[STATS_WINDOW_COUNT] = {
+    STATS_WINDOW_1MIN_SLOTS, STATS_WINDOW_15MIN_SLOTS, STATS_WINDOW_1H_SLOTS};
+
+// `entries` é a faixa da janela; a fila nunca passa de `slots` entradas, já
+// que as que saíram da janela são descartadas antes de cada inclusão
+static inline stats_deque_entry_t *stats_deque_at(stats_deque_t *deque, stats_deque_entry_t *entries,
+                                                  uint8_t slots, uint offset)
+{
+    return &entries[(deque->head + offset) % slots];
+}
+
+// Descarta da frente as entradas que saíram da janela
+static void stats_deque_expire(stats_deque_t *deque, stats_deque_entry_t *entries, uint16_t sequence,
+                               uint8_t slots)
+{
+    while (deque->length && (uint16_t)(sequence - stats_deque_at(deque, entries, slots, 0)->sequence) >= slots)
+    {
+        deque->head = (deque->head + 1) % slots;
+        deque->length--;
+    }
+}
+
+// Remove do fim os valores dominados pelo novo e o acrescenta. `keep_below`
+// escolhe a ordem: verdadeiro para a fila do mínimo
+static void stats_deque_push(stats_deque_t *deque, stats_deque_entry_t *entries, uint8_t slots,
+                             temp_centi_t value, uint16_t sequence, bool keep_below)
+{
+    while (deque->length)
+    {
+        temp_centi_t back = stats_deque_at(deque, entries, slots, deque->length - 1)->value;
+        if (keep_below ? back < value : back > value)
+            break;
+        deque->length--;
+    }
+    stats_deque_entry_t *entry = stats_deque_at(deque, entries, slots, deque->length++);
+    entry->value = value;
+    entry->sequence = sequence;
+}
+
+static void stats_window_push(stream_stats_t *stats, uint index, temp_centi_t min, temp_centi_t max,
+                              int32_t sum, uint8_t count)
+{
+    stats_window_t *window = &stats->windows[index];
+    stats_deque_entry_t *min_entries = &stats->min_entries[window->base];
+    stats_deque_entry_t *max_entries = &stats->max_entries[window->base];
+    uint16_t sequence = ++window->sequence;
+    stats_deque_expire(&window->min, min_entries, sequence, window->slots);
+    stats_deque_expire(&window->max, max_entries, sequence, window->slots);
+    stats_deque_push(&window->min, min_entries, window->slots, min, sequence, true);
+    stats_deque_push(&window->max, max_entries, window->slots, max, sequence, false);
+
+    // Soma deslizante: o bloco mais antigo dá lugar ao novo
+    uint slot = window->base + window->next_slot;
+    window->sum += sum - stats->slot_sum[slot];
+    window->count += count - stats->slot_count[slot];
+    stats->slot_sum[slot] = sum;
+    stats->slot_count[slot] = count;
+    window->next_slot = (window->next_slot + 1) % window->slots;
+}
+
+// Média em Q8, arredondada ao mais próximo
+static int64_t stats_mean_q8(int64_t sum, uint32_t count)
+{
+    int64_t scaled = sum * 256;
+    int64_t half = count / 2;
+    return (scaled + (scaled >= 0 ? half : -half)) / (int64_t)count;
+}
+
+void stream_stats_init(stream_stats_t *stats)
+{
+    memset(stats, 0, sizeof(*stats));
+    stats->min = TEMP_CENTI_HIGHEST;
+    stats->max = TEMP_CENTI_LOWEST;
+    stats->minute_min = TEMP_CENTI_HIGHEST;
+    stats->minute_max = TEMP_CENTI_LOWEST;
+    uint base = 0;
+    for (uint i = 0; i < STATS_WINDOW_COUNT; i++)
+    {
+        stats->windows[i].slots = window_slots[i];
+        stats->windows[i].base = base;
+        base += window_slots[i];
+    }
+}
+
+void stream_stats_add(stream_stats_t *stats, temp_centi_t sample)
+{
+    // Welford em Q8: delta antes e depois de atualizar a média, as duas
+    // tiradas da soma exata
+    int64_t sample_q8 = (int64_t)sample * 256;
+    int64_t delta = stats->count ? sample_q8 - stats_mean_q8(stats->sum, stats->count) : 0;
+    stats->count++;
+    stats->sum += sample;
+    int64_t spread = delta * (sample_q8 - stats_mean_q8(stats->sum, stats->count));
+    stats->m2_q8 += (uint64_t)(spread > 0 ? spread : 0) >> 8;
+    if (sample < stats->min)
+        stats->min = sample;
+    if (sample > stats->max)
+        stats->max = sample;
+
+    stats_window_push(stats, STATS_WINDOW_1MIN, sample, sample, sample, 1);
+
+    if (sample < stats->minute_min)
+        stats->minute_min = sample;
+    if (sample > stats->minute_max)
+        stats->minute_max = sample;
+    stats->minute_sum += sample;
+    if (++stats->minute_count < STATS_SAMPLES_PER_MINUTE)
+        return;
+
+    for (uint i = STATS_WINDOW_15MIN; i < STATS_WINDOW_COUNT; i++)
+    {
+        stats_window_push(stats, i, stats->minute_min, stats->minute_max,
+                          stats->minute_sum, stats->minute_count);
+    }
+    stats->minute_min = TEMP_CENTI_HIGHEST;
+    stats->minute_max = TEMP_CENTI_LOWEST;
+    stats->minute_sum = 0;
+    stats->minute_count = 0;
+}
+
+static uint32_t stats_isqrt64(uint64_t value)
+{
+    uint64_t result = 0;
+    uint64_t bit = 1ull << 62;
+    while (bit > value)
+        bit >>= 2;
+    while (bit)
+    {
+        if (value >= result + bit)
+        {
+            value -= result + bit;
+            result = (result >> 1) + bit;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return result;
+}
+
+bool stream_stats_summary(const stream_stats_t *stats, uint window, stream_stats_summary_t *out)
+{
+    if (stats->count == 0)
+        return false;
+
+    if (window >= STATS_TOTAL)
+    {
+        out->min = stats->min;
+        out->max = stats->max;
+        out->mean = (stats_mean_q8(stats->sum, stats->count) + 128) >> 8;
+        out->count = stats->count;
+        // Desvio padrão amostral: raiz de m2 / (n - 1), de Q16 para centésimos
+        uint64_t variance_q8 = stats->count > 1 ? stats->m2_q8 / (stats->count - 1) : 0;
+        out->stddev = (stats_isqrt64(variance_q8 << 8) + 128) >> 8;
+        return true;
+    }
+
+    const stats_window_t *w = &stats->windows[window];
+    int32_t sum = w->sum;
+    uint32_t count = w->count;
+    temp_centi_t min = w->min.length ? stats->min_entries[w->base + w->min.head].value : TEMP_CENTI_HIGHEST;
+    temp_centi_t max = w->max.length ? stats->max_entries[w->base + w->max.head].value : TEMP_CENTI_LOWEST;
+
+    // As janelas por minuto incluem o minuto em curso
+    if (window != STATS_WINDOW_1MIN && stats->minute_count)
+    {
+        sum += stats->minute_sum;
+        count += stats->minute_count;
+        if (stats->minute_min < min)
+            min = stats->minute_min;
+        if (stats->minute_max > max)
+            max = stats->minute_max;
+    }
+
+    out->min = min;
+    out->max = max;
+    out->mean = count ? sum / (int32_t)count : 0;
+    out->stddev = 0;
+    out->count = count;
+    return count > 0;
+}
@@ -0,0 +1,102 @@
+#ifndef STREAM_STATS_H
+#define STREAM_STATS_H
+
+#include "pico/stdlib.h"
+#include "temperature.h"
+
+// Estatísticas incrementais de um canal, atualizadas a cada amostra de 1 s.
+//
+// - Total desde o início: média pela soma exata em 64 bits e variância pelo
+//   método de Welford sobre essa média (em ponto fixo, sem a perda de
+//   precisão de somar quadrados), mínimo e máximo.
+// - Janelas deslizantes de 1 min, 15 min e 1 h: média por soma deslizante e
+//   mínimo/máximo por filas monotônicas. A janela de 1 min anda por amostra;
+//   as de 15 min e 1 h guardam minutos fechados e a consulta soma a elas o
+//   minuto em curso (minute_min/max/sum), de modo que nenhuma amostra fica
+//   de fora. Em troca cobrem de 15 a 16 min (60 a 61 min): o minuto mais
+//   antigo só sai inteiro, quando o atual fecha.
+//
+// Cada amostra custa O(1) amortizado e a consulta é O(1): a tela não percorre
+// o histórico.
+
+#define STATS_WINDOW_1MIN 0
+#define STATS_WINDOW_15MIN 1
+#define STATS_WINDOW_1H 2
+#define STATS_WINDOW_COUNT 3
+#define STATS_TOTAL STATS_WINDOW_COUNT // Consulta do total desde o início
+
+// Blocos de cada janela: 60 amostras, 15 minutos e 60 minutos. As três
+// dividem os mesmos vetores, cada uma na sua faixa a partir de `base`
+#define STATS_WINDOW_1MIN_SLOTS 60
+#define STATS_WINDOW_15MIN_SLOTS 15
+#define STATS_WINDOW_1H_SLOTS 60
+#define STATS_SLOTS (STATS_WINDOW_1MIN_SLOTS + STATS_WINDOW_15MIN_SLOTS + STATS_WINDOW_1H_SLOTS)
+
+typedef struct
+{
+    temp_centi_t value;
+    uint16_t sequence;
+} stats_deque_entry_t;
+
+// Fila monotônica circular: valores em ordem (crescente para o mínimo,
+// decrescente para o máximo); a frente é o extremo da janela. As entradas
+// ficam em stream_stats_t, na faixa da janela
+typedef struct
+{
+    uint8_t head;
+    uint8_t length;
+} stats_deque_t;
+
+// Janela sobre blocos (amostras ou minutos) com soma deslizante
+typedef struct
+{
+    uint8_t slots;
+    uint8_t base; // Primeira posição da janela nos vetores de stream_stats_t
+    uint8_t next_slot;
+    uint16_t sequence; // Blocos recebidos (com wrap)
+    stats_deque_t min;
+    stats_deque_t max;
+    int32_t sum;
+    uint16_t count;
+} stats_window_t;
+
+typedef struct
+{
+    // Soma das amostras e soma dos quadrados dos desvios (Welford) em Q8. A
+    // média sai da soma a cada amostra: um incremento delta / n acumulado
+    // arredondaria para zero depois de algumas horas
+    uint32_t count;
+    int64_t sum;
+    uint64_t m2_q8;
+    temp_centi_t min;
+    temp_centi_t max;
+
+    // Minuto em formação, alimenta as janelas por minuto
+    temp_centi_t minute_min;
+    temp_centi_t minute_max;
+    int32_t minute_sum;
+    uint8_t minute_count;
+
+    stats_window_t windows[STATS_WINDOW_COUNT];
+    stats_deque_entry_t min_entries[STATS_SLOTS];
+    stats_deque_entry_t max_entries[STATS_SLOTS];
+    int32_t slot_sum[STATS_SLOTS];
+    uint8_t slot_count[STATS_SLOTS];
+} stream_stats_t;
+
+typedef struct
+{
+    temp_centi_t min;
+    temp_centi_t max;
+    temp_centi_t mean;
+    uint16_t stddev; // Só no total; 0 nas janelas
+    uint32_t count;  // Amostras consideradas
+} stream_stats_summary_t;
+
+void stream_stats_init(stream_stats_t *stats);
+void stream_stats_add(stream_stats_t *stats, temp_centi_t sample);
+
+// `window` é STATS_WINDOW_* ou STATS_TOTAL; falso se ainda não há amostras
+bool stream_stats_summary(const stream_stats_t *stats, uint window, stream_stats_summary_t *out);
+
+#endif // STREAM_STATS_H
@@ -0,0 +1,162 @@
+#include "temperature.h"
+#include "seqlock.h"
+#include "temp_lut.h" // Gerado na compilação por tools/gen_temp_lut.py
+#include <stdio.h>
+#include <string.h>
+
+// Cópia em RAM da tabela do modelo com a calibração aplicada. Escrita pelo
+// núcleo 0 ao mudar a calibração; lida pela IRQ de aquisição no núcleo 1.
+static temp_centi_t lut[TEMP_LUT_ENTRIES];
+static seqlock_t lut_lock;
+
+// Interpolação entre as entradas vizinhas: 256 unidades Q12.4 por entrada
+static inline temp_centi_t temperature_interpolate(const int16_t *table, uint16_t adc_q4)
+{
+    uint index = adc_q4 >> 8;
+    int32_t fraction = adc_q4 & 0xFF;
+    int32_t low = table[index];
+    int32_t high = table[index + 1];
+    return low + (((high - low) * fraction + 128) >> 8);
+}
+
+void temperature_init(void)
+{
+    seqlock_write_begin(&lut_lock);
+    memcpy(lut, temp_lut_model, sizeof(lut));
+    seqlock_write_end(&lut_lock);
+}
+
+// Correção (referência - leitura) no ponto `measured`, linear entre os pontos
+// e constante além do primeiro e do último
+static int32_t temperature_correction(const temp_calibration_point_t *points, uint count, int32_t measured)
+{
+    if (count == 0)
+        return 0;
+    if (measured <= points[0].measured)
+        return points[0].reference - points[0].measured;
+    for (uint i = 1; i < count; i++)
+    {
+        if (measured <= points[i].measured)
+        {
+            int32_t x0 = points[i - 1].measured, x1 = points[i].measured;
+            int32_t y0 = points[i - 1].reference - x0, y1 = points[i].reference - x1;
+            return y0 + ((y1 - y0) * (measured - x0)) / (x1 - x0);
+        }
+    }
+    return points[count - 1].reference - points[count - 1].measured;
+}
+
+void temperature_set_calibration(const temp_calibration_point_t *points, uint count)
+{
+    if (count > TEMP_CALIBRATION_MAX_POINTS)
+        count = TEMP_CALIBRATION_MAX_POINTS;
+
+    // Ordena pela leitura do modelo; pontos com a mesma leitura ficam com o último
+    temp_calibration_point_t sorted[TEMP_CALIBRATION_MAX_POINTS];
+    uint used = 0;
+    for (uint i = 0; i < count; i++)
+    {
+        uint pos = used;
+        while (pos > 0 && sorted[pos - 1].measured > points[i].measured)
+            pos--;
+        if (pos > 0 && sorted[pos - 1].measured == points[i].measured)
+        {
+            sorted[pos - 1] = points[i];
+            continue;
+        }
+        memmove(&sorted[pos + 1], &sorted[pos], (used - pos) * sizeof(sorted[0]));
+        sorted[pos] = points[i];
+        used++;
+    }
+
+    // Monta a tabela fora da seção crítica; a IRQ só espera a cópia final
+    temp_centi_t corrected[TEMP_LUT_ENTRIES];
+    for (uint i = 0; i < TEMP_LUT_ENTRIES; i++)
+    {
+        int32_t value = temp_lut_model[i] + temperature_correction(sorted, used, temp_lut_model[i]);
+        if (value > TEMP_CENTI_HIGHEST)
+            value = TEMP_CENTI_HIGHEST;
+        if (value < TEMP_CENTI_LOWEST)
+            value = TEMP_CENTI_LOWEST;
+        corrected[i] = value;
+    }
+
+    seqlock_write_begin(&lut_lock);
+    memcpy(lut, corrected, sizeof(lut));
+    seqlock_write_end(&lut_lock);
+}
+
+temp_centi_t temperature_from_adc_q4(uint16_t adc_q4)
+{
+    uint32_t seq;
+    temp_centi_t value;
+    do
+    {
+        seq = seqlock_read_begin(&lut_lock);
+        value = temperature_interpolate(lut, adc_q4);
+    } while (seqlock_read_retry(&lut_lock, seq));
+    return value;
+}
+
+temp_centi_t temperature_model_from_adc_q4(uint16_t adc_q4)
+{
+    return temperature_interpolate(temp_lut_model, adc_q4);
+}
+
+char *temperature_format(char *buf, temp_centi_t value, uint decimals)
+{
+    static const uint16_t round_divisor[] = {100, 10, 1};
+    if (decimals > 2)
+        decimals = 2;
+
+    int32_t magnitude = value < 0 ? -(int32_t)value : value;
+    uint16_t divisor = round_divisor[decimals];
+    magnitude = (magnitude + divisor / 2) / divisor; // Arredonda na última casa
+
+    const char *sign = (value < 0 && magnitude != 0) ? "-" : "";
+    if (decimals == 0)
+    {
+        snprintf(buf, TEMP_STR_SIZE, "%s%ld", sign, (long)magnitude);
+    }
+    else
+    {
+        uint16_t scale = decimals == 1 ? 10 : 100;
+        snprintf(buf, TEMP_STR_SIZE, "%s%ld.%0*ld", sign, (long)(magnitude / scale),
+                 (int)decimals, (long)(magnitude % scale));
+    }
+    return buf;
+}
+
+bool temperature_parse(const char *text, temp_centi_t *value)
+{
+    bool negative = false;
+    if (*text == '-' || *text == '+')
+        negative = *text++ == '-';
+
+    int32_t centi = 0;
+    uint digits = 0;
+    while (*text >= '0' && *text <= '9')
+    {
+        centi = centi * 10 + (*text++ - '0');
+        digits++;
+        if (centi > 327)
+            return false;
+    }
+    centi *= 100;
+    if (*text == '.')
+    {
+        text++;
+        int32_t scale = 10;
+        while (*text >= '0' && *text <= '9')
+        {
+            centi += (*text++ - '0') * scale; // Casas além da segunda são ignoradas
+            scale /= 10;
+            digits++;
+        }
+    }
+    if (digits == 0 || *text != '\0' || centi > TEMP_CENTI_HIGHEST)
+        return false;
+
+    *value = negative ? -centi : centi;
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef TEMPERATURE_H
+#define TEMPERATURE_H
+
+#include "pico/stdlib.h"
+
+// Temperaturas em ponto fixo: centésimos de grau Celsius em int16_t
+// (-327,68 °C a 327,67 °C).
+//
+// O Cortex-M0+ do RP2040 não tem FPU; cada operação em float vira uma chamada
+// de emulação. Aquisição, histórico, alertas, estatísticas e escala dos
+// gráficos trabalham só com inteiros. O ponto flutuante fica restrito às
+// constantes de configuração, convertidas em tempo de compilação por
+// TEMP_CENTI().
+//
+// A conversão do ADC usa uma tabela de 257 pontos gerada na compilação a
+// partir do modelo do sensor (tools/gen_temp_lut.py, opções TEMP_SENSOR_* do
+// CMake). A calibração de campo é uma correção linear por partes, definida
+// por pares leitura/referência, incorporada a uma cópia da tabela em RAM: a
+// conversão na IRQ continua sendo uma leitura da tabela com interpolação.
+
+typedef int16_t temp_centi_t;
+
+#define TEMP_CENTI(celsius) ((temp_centi_t)((celsius) * 100.0f + ((celsius) < 0 ? -0.5f : 0.5f)))
+#define TEMP_CENTI_LOWEST INT16_MIN
+#define TEMP_CENTI_HIGHEST INT16_MAX
+
+// "-327.68" + terminador cabem em 8; a folga cobre a faixa que o compilador
+// supõe no snprintf de temperature_format (-Wformat-truncation)
+#define TEMP_STR_SIZE 10
+
+// Fundo de escala do ADC no formato Q12.4 do adc_sampler
+#define TEMP_ADC_Q4_FULL_SCALE (4095u << 4)
+
+#define TEMP_CALIBRATION_MAX_POINTS 8
+
+// Ponto de calibração: o que o modelo do sensor indicou e o que o termômetro
+// de referência mediu no mesmo instante
+typedef struct
+{
+    temp_centi_t measured;
+    temp_centi_t reference;
+} temp_calibration_point_t;
+
+// Carrega a tabela do modelo, sem correção
+void temperature_init(void);
+
+// Substitui a correção de campo (pontos em qualquer ordem; 0 pontos remove).
+// Pode ser chamada com a aquisição rodando no outro núcleo.
+void temperature_set_calibration(const temp_calibration_point_t *points, uint count);
+
+// Converte uma leitura Q12.4 em centésimos de grau (com a calibração)
+temp_centi_t temperature_from_adc_q4(uint16_t adc_q4);
+
+// Converte uma leitura Q12.4 só pelo modelo, para registrar pontos de calibração
+temp_centi_t temperature_model_from_adc_q4(uint16_t adc_q4);
+
+// Escreve `value` com 0 a 2 casas decimais em `buf` (TEMP_STR_SIZE bytes)
+char *temperature_format(char *buf, temp_centi_t value, uint decimals);
+
+// Lê "25", "-3.5" ou "25.47" em centésimos; falso se não for um número
+bool temperature_parse(const char *text, temp_centi_t *value);
+
+#endif // TEMPERATURE_H
@@ -0,0 +1,113 @@
+#include "usb_stream.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+
+#define STREAM_TX_SIZE 2048 // Potência de 2
+#define STREAM_RX_SIZE 64   // Comandos do host são curtos
+
+static bool active = false;
+static uint8_t tx_buffer[STREAM_TX_SIZE];
+static uint32_t tx_head; // Contadores livres, como em lib/spsc_ring
+static uint32_t tx_tail;
+static uint32_t dropped;
+
+static uint8_t rx_buffer[STREAM_RX_SIZE];
+static frame_decoder_t rx_decoder;
+
+// Quadro montado fora da fila e copiado se couber
+static uint8_t encoded[FRAME_ENCODED_SIZE(FRAME_MAX_PAYLOAD)];
+
+void usb_stream_start(void)
+{
+    // Um delimitador antes de tudo separa o texto já enviado do primeiro quadro
+    tx_buffer[0] = 0;
+    tx_tail = 0;
+    tx_head = 1;
+    frame_decoder_init(&rx_decoder, rx_buffer, sizeof(rx_buffer));
+    active = true;
+}
+
+void usb_stream_stop(void)
+{
+    active = false;
+}
+
+bool usb_stream_active(void)
+{
+    return active;
+}
+
+bool usb_stream_fits(uint16_t length)
+{
+    return STREAM_TX_SIZE - (tx_head - tx_tail) >= FRAME_ENCODED_SIZE(length);
+}
+
+bool usb_stream_send(uint8_t type, const void *payload, uint16_t length)
+{
+    if (!active)
+        return false;
+    if (length > FRAME_MAX_PAYLOAD || !usb_stream_fits(length))
+    {
+        dropped++;
+        return false;
+    }
+    size_t size = frame_encode(type, payload, length, encoded);
+    for (size_t i = 0; i < size; i++)
+    {
+        tx_buffer[tx_head++ & (STREAM_TX_SIZE - 1)] = encoded[i];
+    }
+    return true;
+}
+
+void usb_stream_pump(void)
+{
+    if (!active)
+        return;
+    if (!stdio_usb_connected())
+    {
+        // Host fechou a porta: volta ao texto para a próxima conexão
+        usb_stream_stop();
+        return;
+    }
+
+    while (tx_head != tx_tail)
+    {
+        // Só o que cabe no buffer do TinyUSB: out_chars não chega a esperar
+        uint32_t space = tud_cdc_write_available();
+        uint32_t start = tx_tail & (STREAM_TX_SIZE - 1);
+        uint32_t chunk = tx_head - tx_tail;
+        if (chunk > STREAM_TX_SIZE - start)
+            chunk = STREAM_TX_SIZE - start;
+        if (chunk > space)
+            chunk = space;
+        if (chunk == 0)
+            return;
+        stdio_usb.out_chars((const char *)&tx_buffer[start], chunk);
+        tx_tail += chunk;
+    }
+}
+
+bool usb_stream_pending(void)
+{
+    return active && tx_head != tx_tail;
+}
+
+bool usb_stream_receive(uint8_t byte, uint8_t *type, const uint8_t **payload, uint16_t *length)
+{
+    if (!frame_decoder_feed(&rx_decoder, byte))
+        return false;
+    *type = rx_decoder.type;
+    *payload = rx_decoder.payload;
+    *length = rx_decoder.payload_length;
+    return true;
+}
+
+uint32_t usb_stream_dropped(void)
+{
+    return dropped;
+}
+
+uint32_t usb_stream_rx_errors(void)
+{
+    return rx_decoder.errors;
+}
@@ -0,0 +1,140 @@
+#ifndef USB_STREAM_H
+#define USB_STREAM_H
+
+#include "pico/stdlib.h"
+#include "frame.h"
+
+// Protocolo binário pela USB CDC, no lugar do texto enquanto estiver ativo.
+//
+// O comando de texto "stream" liga o modo binário; o quadro
+// STREAM_CMD_STOP volta ao texto. Os quadros (lib/frame) vão para uma fila
+// em RAM e saem só quando o TinyUSB tem espaço: nada bloqueia o laço
+// principal, e a aquisição no núcleo 1 não participa. Com a fila cheia os
+// quadros ao vivo são descartados e contados; os downloads esperam espaço.
+// tools/stream_decode.py decodifica o fluxo no host e tools/oled_mirror.py
+// mostra o espelho do display.
+//
+// Conteúdos em little-endian, sem preenchimento.
+
+#define STREAM_PROTOCOL_VERSION 3
+
+// Dispositivo -> host
+#define STREAM_MSG_INFO 0x01    // stream_msg_info_t, ao ligar
+#define STREAM_MSG_SAMPLE 0x02  // stream_msg_sample_t + stream_msg_channel_t por canal
+#define STREAM_MSG_STATS 0x03   // stream_msg_stats_t, por canal e janela, a cada minuto
+#define STREAM_MSG_ALERT 0x04   // stream_msg_alert_t, a cada mudança de alerta
+#define STREAM_MSG_HISTORY 0x05 // stream_msg_history_t + registros (min, max, média)
+#define STREAM_MSG_ARCHIVE 0x06 // Página do arquivo na flash, como gravada
+#define STREAM_MSG_END 0x07     // stream_msg_end_t, fim de um download
+#define STREAM_MSG_STATUS 0x08  // stream_msg_status_t, a cada minuto
+#define STREAM_MSG_MIRROR 0x09  // Quadro do espelho do display (lib/display_mirror.h)
+
+// Host -> dispositivo
+#define STREAM_CMD_STOP 0x80
+#define STREAM_CMD_HISTORY 0x81 // stream_cmd_history_t
+#define STREAM_CMD_ARCHIVE 0x82
+#define STREAM_CMD_MIRROR 0x83 // stream_cmd_mirror_t
+
+#define STREAM_HISTORY_CHUNK 32 // Registros por quadro de histórico
+
+typedef struct __attribute__((packed))
+{
+    uint8_t version;
+    uint8_t channels;
+    uint16_t scan_interval_ms;
+    uint8_t history_tiers;
+    uint8_t archive_fields; // Campos int16 por registro do arquivo
+} stream_msg_info_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t sequence; // Varredura
+} stream_msg_sample_t;
+
+typedef struct __attribute__((packed))
+{
+    uint16_t adc_q4;
+    int16_t temp; // Centésimos de grau
+} stream_msg_channel_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t channel;
+    uint8_t window; // STATS_WINDOW_* ou STATS_TOTAL
+    int16_t min;
+    int16_t max;
+    int16_t mean;
+    uint16_t stddev;
+    uint32_t count;
+} stream_msg_stats_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t sequence;
+    uint8_t channel;
+    uint8_t previous;
+    uint8_t current;
+    int16_t temp;
+} stream_msg_alert_t;
+
+// O download cobre os registros retidos quando o comando chegou, do mais
+// antigo ao mais novo, por índice absoluto no nível (history_written): os
+// quadros se emendam por first_index mesmo com registros chegando no meio.
+// Se o anel sobrescreve registros ainda não enviados o download termina antes
+// e o host vê a falta pelos índices.
+typedef struct __attribute__((packed))
+{
+    uint8_t channel;
+    uint8_t tier;
+    uint32_t first_index; // Índice absoluto do primeiro registro do quadro
+    uint32_t end_index;   // Fim do download (exclusivo): o mais novo é end_index - 1
+} stream_msg_history_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t kind; // STREAM_MSG_HISTORY ou STREAM_MSG_ARCHIVE
+    uint32_t frames;
+} stream_msg_end_t;
+
+typedef struct __attribute__((packed))
+{
+    uint32_t scans;
+    uint32_t ring_dropped;   // Varreduras perdidas entre os núcleos
+    uint32_t stream_dropped; // Quadros ao vivo descartados por fila cheia
+    uint32_t rx_errors;      // Quadros recebidos inválidos
+} stream_msg_status_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t channel;
+    uint8_t tier;
+} stream_cmd_history_t;
+
+typedef struct __attribute__((packed))
+{
+    uint8_t enable; // Ligar de novo recomeça com um quadro-chave
+} stream_cmd_mirror_t;
+
+void usb_stream_start(void);
+void usb_stream_stop(void);
+bool usb_stream_active(void);
+
+// Enfileira um quadro; falso se não couber (descartado e contado)
+bool usb_stream_send(uint8_t type, const void *payload, uint16_t length);
+
+// Verdadeiro se um quadro de `length` bytes de conteúdo cabe agora na fila
+bool usb_stream_fits(uint16_t length);
+
+// Entrega à USB o que couber; chamar a cada volta do laço principal
+void usb_stream_pump(void);
+
+// Verdadeiro enquanto há bytes na fila esperando a USB
+bool usb_stream_pending(void);
+
+// Byte recebido no modo binário; verdadeiro quando fecha um comando válido
+bool usb_stream_receive(uint8_t byte, uint8_t *type, const uint8_t **payload, uint16_t *length);
+
+uint32_t usb_stream_dropped(void);
+uint32_t usb_stream_rx_errors(void);
+
+#endif // USB_STREAM_H
@@ -0,0 +1,175 @@
+#include "widgets.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+static const widget_screen_t *shown = NULL; // Tela com a camada estática no display
+
+void widget_value_render(widget_t *widget, ssd1306_t *ssd)
+{
+    widget_value_t *value = (widget_value_t *)widget;
+    char text[WIDGET_TEXT_SIZE];
+    size_t chars = widget->width / 8;
+    if (chars >= sizeof(text))
+        chars = sizeof(text) - 1;
+    // Corta no tamanho da caixa: o resto cairia fora do retângulo limpo
+    strncpy(text, value->text, chars);
+    text[chars] = '\0';
+    ssd1306_draw_string(ssd, text, widget->x, widget->y);
+}
+
+void widget_sparkline_render(widget_t *widget, ssd1306_t *ssd)
+{
+    widget_sparkline_t *sparkline = (widget_sparkline_t *)widget;
+    uint8_t right = widget->x + widget->width - 1;
+    if (sparkline->baseline)
+        ssd1306_hline(ssd, widget->x, right, widget->y + widget->height - 1, true);
+    for (uint8_t i = 0; i < sparkline->count; i++)
+    {
+        if (sparkline->range)
+            ssd1306_vline(ssd, right - i, sparkline->high[i], sparkline->low[i], true);
+        if (i + 1 < sparkline->count)
+            ssd1306_line(ssd, right - i, sparkline->mean[i], right - i - 1, sparkline->mean[i + 1], true);
+    }
+}
+
+void widget_box_render(widget_t *widget, ssd1306_t *ssd)
+{
+    if (((widget_box_t *)widget)->visible)
+        ssd1306_rect(ssd, widget->y, widget->x, widget->width, widget->height, true, false);
+}
+
+void widget_list_render(widget_t *widget, ssd1306_t *ssd)
+{
+    widget_list_t *list = (widget_list_t *)widget;
+    uint8_t first = 0;
+    if (list->selected >= list->visible)
+        first = list->selected - list->visible + 1;
+
+    // Setas de rolagem, por baixo dos itens como no menu original
+    uint8_t arrow_x = widget->x + 50;
+    if (first > 0)
+        ssd1306_draw_string(ssd, "^", arrow_x, widget->y);
+    if (first + list->visible < list->count)
+        ssd1306_draw_string(ssd, "v", arrow_x, widget->y + (list->visible - 1) * list->row_height);
+
+    for (uint8_t i = 0; i < list->visible && first + i < list->count; i++)
+    {
+        uint8_t item = first + i;
+        char line[WIDGET_TEXT_SIZE];
+        snprintf(line, sizeof(line), "%s%s", item == list->selected ? "> " : "  ", list->items[item]);
+        ssd1306_draw_string(ssd, line, widget->x, widget->y + i * list->row_height);
+    }
+}
+
+void widget_value_set(widget_value_t *value, const char *text)
+{
+    if (strncmp(value->text, text, sizeof(value->text) - 1) == 0)
+        return;
+    strncpy(value->text, text, sizeof(value->text) - 1);
+    value->text[sizeof(value->text) - 1] = '\0';
+    value->base.dirty = true;
+}
+
+void widget_value_printf(widget_value_t *value, const char *format, ...)
+{
+    char text[WIDGET_TEXT_SIZE];
+    va_list args;
+    va_start(args, format);
+    vsnprintf(text, sizeof(text), format, args);
+    va_end(args);
+    widget_value_set(value, text);
+}
+
+void widget_sparkline_set(widget_sparkline_t *sparkline, const uint8_t *mean,
+                          const uint8_t *low, const uint8_t *high, uint8_t count)
+{
+    if (count > WIDGET_SPARKLINE_MAX)
+        count = WIDGET_SPARKLINE_MAX;
+    if (count > sparkline->base.width)
+        count = sparkline->base.width;
+    bool range = low && high;
+    if (count == sparkline->count && range == sparkline->range &&
+        memcmp(sparkline->mean, mean, count) == 0 &&
+        (!range || (memcmp(sparkline->low, low, count) == 0 &&
+                    memcmp(sparkline->high, high, count) == 0)))
+        return;
+
+    sparkline->count = count;
+    sparkline->range = range;
+    memcpy(sparkline->mean, mean, count);
+    if (range)
+    {
+        memcpy(sparkline->low, low, count);
+        memcpy(sparkline->high, high, count);
+    }
+    sparkline->base.dirty = true;
+}
+
+void widget_box_set(widget_box_t *box, bool visible)
+{
+    if (box->visible == visible)
+        return;
+    box->visible = visible;
+    box->base.dirty = true;
+}
+
+void widget_list_select(widget_list_t *list, uint8_t selected)
+{
+    if (list->selected == selected)
+        return;
+    list->selected = selected;
+    list->base.dirty = true;
+}
+
+static inline bool widget_overlaps(const widget_t *a, const widget_t *b)
+{
+    return a->x < b->x + b->width && b->x < a->x + a->width &&
+           a->y < b->y + b->height && b->y < a->y + a->height;
+}
+
+uint widget_screen_render(ssd1306_t *ssd, const widget_screen_t *screen)
+{
+    if (screen != shown)
+    {
+        ssd1306_fill(ssd, false);
+        for (uint8_t i = 0; i < screen->label_count; i++)
+        {
+            ssd1306_draw_string(ssd, screen->labels[i].text, screen->labels[i].x, screen->labels[i].y);
+        }
+        if (screen->draw_static)
+            screen->draw_static(ssd);
+        for (uint8_t i = 0; i < screen->widget_count; i++)
+        {
+            screen->widgets[i]->dirty = true;
+        }
+        shown = screen;
+    }
+
+    if (screen->bind)
+        screen->bind();
+
+    uint rendered = 0;
+    for (uint8_t i = 0; i < screen->widget_count; i++)
+    {
+        widget_t *widget = screen->widgets[i];
+        if (!widget->dirty)
+            continue;
+        ssd1306_fill_rect(ssd, widget->y, widget->x, widget->width, widget->height, false);
+        widget->render(widget, ssd);
+        widget->dirty = false;
+        rendered++;
+        // A limpeza apagou o que estava por cima: redesenha nesta mesma passada
+        for (uint8_t j = i + 1; j < screen->widget_count; j++)
+        {
+            if (widget_overlaps(widget, screen->widgets[j]))
+                screen->widgets[j]->dirty = true;
+        }
+    }
+    return rendered;
+}
+
+void widget_screen_invalidate(void)
+{
+    shown = NULL;
+}
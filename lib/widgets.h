@@ -0,0 +1,118 @@
+#ifndef WIDGETS_H
+#define WIDGETS_H
+
+#include "ssd1306.h"
+
+// Interface retida sobre o ssd1306.
+//
+// Cada tela tem uma camada estática (rótulos, títulos, linhas), desenhada
+// uma vez quando a tela entra, e uma lista de widgets ligados a valores. A
+// cada quadro a tela só atualiza os valores (bind); um widget cujo valor não
+// mudou não é redesenhado. O widget sujo limpa e redesenha o próprio
+// retângulo, e só essas regiões vão para o envio parcial do display.
+//
+// Os widgets são opacos e a ordem da lista é a de empilhamento: redesenhar
+// um widget também redesenha os seguintes que o cobrem. A camada estática
+// não deve ficar sob widgets, que a apagariam ao limpar o retângulo.
+
+#define WIDGET_TEXT_SIZE 24
+#define WIDGET_SPARKLINE_MAX 128
+
+typedef struct widget widget_t;
+typedef void (*widget_render_t)(widget_t *widget, ssd1306_t *ssd);
+
+struct widget
+{
+    uint8_t x, y, width, height;
+    bool dirty;
+    widget_render_t render;
+};
+
+// Rótulo fixo, parte da camada estática
+typedef struct
+{
+    uint8_t x, y;
+    const char *text;
+} widget_label_t;
+
+// Campo de valor: uma linha de texto numa caixa de `chars` caracteres
+typedef struct
+{
+    widget_t base;
+    char text[WIDGET_TEXT_SIZE];
+} widget_value_t;
+
+// Linha de tendência: ponto 0 na coluna da direita, em linhas da tela
+typedef struct
+{
+    widget_t base;
+    bool baseline; // Redesenha a linha da base (eixo) ao limpar
+    bool range;    // Barras verticais entre low e high em cada ponto
+    uint8_t count;
+    uint8_t mean[WIDGET_SPARKLINE_MAX];
+    uint8_t low[WIDGET_SPARKLINE_MAX];
+    uint8_t high[WIDGET_SPARKLINE_MAX];
+} widget_sparkline_t;
+
+// Moldura que aparece ou some (ex: destaque de alerta)
+typedef struct
+{
+    widget_t base;
+    bool visible;
+} widget_box_t;
+
+// Lista de menu com seleção e rolagem
+typedef struct
+{
+    widget_t base;
+    const char *const *items;
+    uint8_t count;
+    uint8_t visible;    // Itens por tela
+    uint8_t row_height;
+    uint8_t selected;
+} widget_list_t;
+
+void widget_value_render(widget_t *widget, ssd1306_t *ssd);
+void widget_sparkline_render(widget_t *widget, ssd1306_t *ssd);
+void widget_box_render(widget_t *widget, ssd1306_t *ssd);
+void widget_list_render(widget_t *widget, ssd1306_t *ssd);
+
+#define WIDGET_VALUE(x, y, chars) \
+    {.base = {(x), (y), (chars) * 8, 8, true, widget_value_render}}
+#define WIDGET_SPARKLINE(x, y, width, height) \
+    {.base = {(x), (y), (width), (height), true, widget_sparkline_render}}
+#define WIDGET_BOX(x, y, width, height) \
+    {.base = {(x), (y), (width), (height), true, widget_box_render}}
+#define WIDGET_LIST(x, y, width, items_, count_, visible_, row_height_)       \
+    {.base = {(x), (y), (width), (visible_) * (row_height_), true, widget_list_render}, \
+     .items = (items_), .count = (count_), .visible = (visible_), .row_height = (row_height_)}
+
+// Atualizações: marcam o widget sujo só se o valor mudou
+void widget_value_set(widget_value_t *value, const char *text);
+void widget_value_printf(widget_value_t *value, const char *format, ...)
+    __attribute__((format(printf, 2, 3)));
+// `low` e `high` nulos: sem barras de faixa
+void widget_sparkline_set(widget_sparkline_t *sparkline, const uint8_t *mean,
+                          const uint8_t *low, const uint8_t *high, uint8_t count);
+void widget_box_set(widget_box_t *box, bool visible);
+void widget_list_select(widget_list_t *list, uint8_t selected);
+
+typedef struct
+{
+    const widget_label_t *labels;
+    uint8_t label_count;
+    void (*draw_static)(ssd1306_t *ssd); // Linhas e demais traços fixos (opcional)
+    void (*bind)(void);                  // Atualiza os valores dos widgets
+    widget_t *const *widgets;
+    uint8_t widget_count;
+} widget_screen_t;
+
+// Desenha a tela: na troca, limpa o display, desenha a camada estática e
+// invalida os widgets; depois atualiza os valores e redesenha os sujos.
+// Devolve quantos widgets foram redesenhados.
+uint widget_screen_render(ssd1306_t *ssd, const widget_screen_t *screen);
+
+// Esquece a tela desenhada: o próximo render redesenha tudo
+void widget_screen_invalidate(void);
+
+#endif // WIDGETS_H
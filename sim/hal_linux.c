@@ -0,0 +1,228 @@
+#include "hal_linux.h"
+#include <time.h>
+
+#define HAL_LINUX_GPIOS 30
+#define HAL_LINUX_AUX_INPUTS 4
+
+static uint64_t now_us;
+
+static const hal_sensor_config_t *sensor_config;
+static hal_scan_callback_t scan_callback;
+static hal_linux_source_t scan_source;
+static uint64_t next_scan_us;
+
+static uint16_t aux[HAL_LINUX_AUX_INPUTS] = {2048, 2048, 2048, 2048};
+static uint16_t led_level[HAL_LINUX_GPIOS];
+static hal_button_callback_t button_callback[HAL_LINUX_GPIOS];
+
+// Painel emulado: mesma organização do ram_buffer (8 páginas por coluna)
+static uint8_t panel[HAL_LINUX_PANEL_BYTES];
+static hal_linux_stats_t stats;
+
+uint32_t hal_time_ms(void)
+{
+    return (uint32_t)(now_us / 1000);
+}
+
+uint32_t hal_time_us(void)
+{
+    return (uint32_t)now_us;
+}
+
+// Ciclos: nanossegundos reais do PC, para a instrumentação medir o código
+void hal_cycles_init(void)
+{
+}
+
+uint32_t hal_cycles_hz(void)
+{
+    return 1000000000u;
+}
+
+uint32_t hal_cycles(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)((uint64_t)now.tv_sec * 1000000000u + now.tv_nsec) & HAL_CYCLES_MASK;
+}
+
+void hal_sensors_start(const hal_sensor_config_t *config, hal_scan_callback_t done)
+{
+    sensor_config = config;
+    scan_callback = done;
+    next_scan_us = now_us + (uint64_t)config->interval_ms * 1000;
+}
+
+void hal_linux_set_source(hal_linux_source_t source)
+{
+    scan_source = source;
+}
+
+bool hal_linux_advance_ms(uint32_t ms)
+{
+    uint64_t target = now_us + (uint64_t)ms * 1000;
+    while (scan_callback && next_scan_us <= target)
+    {
+        uint16_t adc_q4[SENSOR_MAX_CHANNELS];
+        now_us = next_scan_us;
+        if (!scan_source || !scan_source(stats.scans, adc_q4, sensor_config->channel_count))
+        {
+            now_us = target;
+            return false;
+        }
+        stats.scans++;
+        scan_callback(adc_q4, stats.scans);
+        next_scan_us += (uint64_t)sensor_config->interval_ms * 1000;
+    }
+    now_us = target;
+    return true;
+}
+
+void hal_adc_init(uint8_t input)
+{
+}
+
+uint16_t hal_adc_read_aux(uint8_t input)
+{
+    return input < HAL_LINUX_AUX_INPUTS ? aux[input] : 0;
+}
+
+void hal_linux_set_aux(uint8_t input, uint16_t value)
+{
+    if (input < HAL_LINUX_AUX_INPUTS)
+        aux[input] = value;
+}
+
+void hal_display_init(ssd1306_t *ssd, const hal_display_config_t *config,
+                      ssd1306_flush_callback_t done, void *context)
+{
+    // Sem ssd1306_dma_init(): o envio fica no caminho por polling
+    ssd1306_init(ssd, 128, 64, false, config->address, config->i2c);
+    ssd1306_config(ssd);
+    ssd1306_set_flush_callback(ssd, done, context);
+}
+
+bool hal_display_busy(ssd1306_t *ssd)
+{
+    return false;
+}
+
+// Interpreta o stream I2C como o controlador do display: transações
+// terminadas pelo bit de STOP, cada uma de comandos (0x00) ou dados (0x40)
+static void panel_decode(const uint16_t *stream, size_t length)
+{
+    uint8_t col0 = 0, col1 = 127, page0 = 0, page1 = 7;
+    uint8_t col = 0, page = 0;
+    size_t i = 0;
+    while (i < length)
+    {
+        size_t end = i;
+        while (end < length && !(stream[end] & I2C_IC_DATA_CMD_STOP_BITS))
+            end++;
+        if (end == length)
+            end--; // Transação sem STOP: usa o que houver
+        uint8_t control = stream[i] & 0xFF;
+        if (control == 0x40)
+        {
+            for (size_t j = i + 1; j <= end; j++)
+            {
+                panel[(col << 3) + page] = stream[j] & 0xFF;
+                // Modo vertical: desce as páginas antes de avançar a coluna
+                if (page < page1)
+                {
+                    page++;
+                    continue;
+                }
+                page = page0;
+                col = col < col1 ? col + 1 : col0;
+            }
+        }
+        else
+        {
+            for (size_t j = i + 1; j <= end; j++)
+            {
+                uint8_t command = stream[j] & 0xFF;
+                if (command == SET_COL_ADDR && j + 2 <= end)
+                {
+                    col = col0 = stream[j + 1] & 0x7F;
+                    col1 = stream[j + 2] & 0x7F;
+                    j += 2;
+                }
+                else if (command == SET_PAGE_ADDR && j + 2 <= end)
+                {
+                    page = page0 = stream[j + 1] & 0x07;
+                    page1 = stream[j + 2] & 0x07;
+                    j += 2;
+                }
+            }
+        }
+        stats.stream_words += end - i + 1;
+        i = end + 1;
+    }
+}
+
+bool hal_display_flush(ssd1306_t *ssd)
+{
+    if (!ssd1306_send_data_async(ssd))
+        return false;
+    panel_decode(ssd->tx_stream, ssd->tx_len);
+    stats.flushes++;
+    stats.flushed_bytes += ssd->last_flush_bytes;
+    return true;
+}
+
+const uint8_t *hal_linux_panel(void)
+{
+    return panel;
+}
+
+bool hal_linux_write_pbm(const char *path)
+{
+    FILE *file = fopen(path, "wb");
+    if (!file)
+        return false;
+    fprintf(file, "P4\n128 64\n");
+    for (uint8_t y = 0; y < 64; y++)
+    {
+        uint8_t row[128 / 8] = {0};
+        for (uint8_t x = 0; x < 128; x++)
+        {
+            if (panel[(x << 3) + (y >> 3)] & (1u << (y & 7)))
+                row[x >> 3] |= 0x80 >> (x & 7);
+        }
+        fwrite(row, 1, sizeof(row), file);
+    }
+    return fclose(file) == 0;
+}
+
+void hal_led_init(uint gpio)
+{
+}
+
+void hal_led_set(uint gpio, uint16_t level)
+{
+    if (gpio < HAL_LINUX_GPIOS)
+        led_level[gpio] = level;
+}
+
+uint16_t hal_linux_led(uint gpio)
+{
+    return gpio < HAL_LINUX_GPIOS ? led_level[gpio] : 0;
+}
+
+void hal_button_init(uint gpio, hal_button_callback_t callback)
+{
+    if (gpio < HAL_LINUX_GPIOS)
+        button_callback[gpio] = callback;
+}
+
+void hal_linux_press(uint gpio)
+{
+    if (gpio < HAL_LINUX_GPIOS && button_callback[gpio])
+        button_callback[gpio](gpio, GPIO_IRQ_EDGE_FALL);
+}
+
+const hal_linux_stats_t *hal_linux_stats(void)
+{
+    return &stats;
+}
@@ -0,0 +1,49 @@
+#ifndef HAL_LINUX_H
+#define HAL_LINUX_H
+
+#include "hal.h"
+
+// Controles da HAL de Linux (sim/hal_linux.c), usados pelo simulador.
+//
+// O tempo só anda quando o simulador manda: hal_linux_advance_ms() avança o
+// relógio e entrega as varreduras vencidas, com as leituras pedidas à fonte.
+// O display é um painel SSD1306 emulado que decodifica o mesmo stream I2C
+// que o firmware envia (janelas e dados no modo vertical).
+
+#define HAL_LINUX_PANEL_BYTES (128 * 8)
+
+// Preenche a varredura `scan` (a partir de 0) com uma leitura Q12.4 por
+// canal; falso quando a série acabou
+typedef bool (*hal_linux_source_t)(uint32_t scan, uint16_t *adc_q4, uint8_t channels);
+
+typedef struct
+{
+    uint32_t scans;         // Varreduras entregues
+    uint32_t flushes;       // Envios ao display com alguma mudança
+    uint32_t flushed_bytes; // Bytes de dados do framebuffer enviados
+    uint32_t stream_words;  // Palavras do stream I2C (comandos e dados)
+} hal_linux_stats_t;
+
+void hal_linux_set_source(hal_linux_source_t source);
+
+// Avança o relógio simulado; falso se a fonte acabou
+bool hal_linux_advance_ms(uint32_t ms);
+
+// Botão pressionado agora (borda de descida)
+void hal_linux_press(uint gpio);
+
+// Valor de uma entrada auxiliar do ADC (joystick; 2048 = centro)
+void hal_linux_set_aux(uint8_t input, uint16_t value);
+
+// Nível atual do PWM de um LED
+uint16_t hal_linux_led(uint gpio);
+
+// Conteúdo do painel emulado: 8 bytes (páginas) por coluna
+const uint8_t *hal_linux_panel(void);
+
+// Grava o painel como PBM binário (pixel aceso = preto)
+bool hal_linux_write_pbm(const char *path);
+
+const hal_linux_stats_t *hal_linux_stats(void);
+
+#endif // HAL_LINUX_H
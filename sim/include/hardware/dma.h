@@ -0,0 +1,73 @@
+#ifndef SIM_HARDWARE_DMA_H
+#define SIM_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+// Sem DMA no simulador: o ssd1306 fica no envio por polling (dma_channel -1)
+// e estas funções nunca são chamadas, só precisam existir
+
+#define NUM_DMA_CHANNELS 12
+#define DMA_IRQ_0 11
+
+typedef struct
+{
+    uint32_t ctrl;
+} dma_channel_config;
+
+enum dma_channel_transfer_size
+{
+    DMA_SIZE_8 = 0,
+    DMA_SIZE_16 = 1,
+    DMA_SIZE_32 = 2
+};
+
+static inline int dma_claim_unused_channel(bool required)
+{
+    return -1;
+}
+
+static inline bool dma_channel_is_busy(uint channel)
+{
+    return false;
+}
+
+static inline dma_channel_config dma_channel_get_default_config(uint channel)
+{
+    return (dma_channel_config){0};
+}
+
+static inline void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size)
+{
+}
+
+static inline void channel_config_set_read_increment(dma_channel_config *c, bool incr)
+{
+}
+
+static inline void channel_config_set_write_increment(dma_channel_config *c, bool incr)
+{
+}
+
+static inline void channel_config_set_dreq(dma_channel_config *c, uint dreq)
+{
+}
+
+static inline void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                                         const volatile void *read_addr, uint transfer_count, bool trigger)
+{
+}
+
+static inline void dma_channel_set_irq0_enabled(uint channel, bool enabled)
+{
+}
+
+static inline bool dma_channel_get_irq0_status(uint channel)
+{
+    return false;
+}
+
+static inline void dma_channel_acknowledge_irq0(uint channel)
+{
+}
+
+#endif // SIM_HARDWARE_DMA_H
@@ -0,0 +1,18 @@
+#ifndef SIM_HARDWARE_IRQ_H
+#define SIM_HARDWARE_IRQ_H
+
+#include "pico/stdlib.h"
+
+#define PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY 0x80
+
+typedef void (*irq_handler_t)(void);
+
+static inline void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority)
+{
+}
+
+static inline void irq_set_enabled(uint num, bool enabled)
+{
+}
+
+#endif // SIM_HARDWARE_IRQ_H
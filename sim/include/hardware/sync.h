@@ -0,0 +1,53 @@
+#ifndef SIM_HARDWARE_SYNC_H
+#define SIM_HARDWARE_SYNC_H
+
+#include "pico/stdlib.h"
+
+// O simulador roda numa thread só: travas e eventos de CPU viram nada
+
+typedef volatile uint32_t spin_lock_t;
+
+static inline int spin_lock_claim_unused(bool required)
+{
+    return 0;
+}
+
+static inline spin_lock_t *spin_lock_init(uint lock_num)
+{
+    static spin_lock_t lock;
+    return &lock;
+}
+
+static inline uint32_t spin_lock_blocking(spin_lock_t *lock)
+{
+    return 0;
+}
+
+static inline void spin_unlock(spin_lock_t *lock, uint32_t saved_irq)
+{
+}
+
+static inline uint32_t save_and_disable_interrupts(void)
+{
+    return 0;
+}
+
+static inline void restore_interrupts(uint32_t status)
+{
+}
+
+static inline void __sev(void)
+{
+}
+
+static inline void __wfi(void)
+{
+}
+
+// Sem IRQs para acordar: o prazo é sempre tratado como vencido
+static inline bool best_effort_wfe_or_timeout(absolute_time_t timeout_timestamp)
+{
+    return true;
+}
+
+#endif // SIM_HARDWARE_SYNC_H
@@ -0,0 +1,34 @@
+#ifndef SIM_PICO_STDLIB_H
+#define SIM_PICO_STDLIB_H
+
+// Subconjunto do SDK do Pico para compilar os módulos portáveis no PC
+// (sim/CMakeLists.txt): só tipos, macros e funções sem efeito em hardware.
+// O que a aplicação usa do hardware passa pela HAL (lib/hal.h).
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef unsigned int uint;
+typedef uint64_t absolute_time_t;
+typedef struct alarm_pool alarm_pool_t;
+
+#define count_of(a) (sizeof(a) / sizeof((a)[0]))
+#define __not_in_flash_func(func_name) func_name
+#define __isr
+
+static inline void tight_loop_contents(void)
+{
+}
+
+static inline uint get_core_num(void)
+{
+    return 0;
+}
+
+#define GPIO_IRQ_EDGE_FALL 0x4u
+#define GPIO_IRQ_EDGE_RISE 0x8u
+
+#endif // SIM_PICO_STDLIB_H
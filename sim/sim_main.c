@@ -0,0 +1,290 @@
+// Simulador do monitor no PC.
+//
+// Roda a aquisição, as estatísticas, os alertas e as telas do firmware sobre
+// a HAL de Linux (sim/hal_linux.c), alimentado por uma série de temperaturas
+// sintética ou gravada, e grava os quadros do display em PBM:
+//
+//   monitor_sim [--seconds N] [--trace ARQ | --raw-trace ARQ] [--screen TELA]
+//               [--zoom 1s|1m|15m|1h] [--channel N] [--frames DIR] [--every N]
+//               [--out ARQ]
+//
+// --trace lê uma varredura por linha, temperaturas em graus por canal
+// (separadas por vírgula ou espaço; '#' comenta); --raw-trace lê leituras
+// Q12.4 do ADC. Sem série, gera 30 min com ciclo lento, ruído e um pico que
+// passa pelos três níveis de alerta. O resumo sai em "chave valor" por linha,
+// para comparar entre versões.
+//
+// A aplicação entra inteira nesta unidade, compilada com MONITOR_APP_ONLY (sem
+// USB, Modbus, flash e o laço do firmware): o simulador usa o estado dela direto.
+
+#include "System_Monitor_Temp_PV.c"
+#include "hal_linux.h"
+#include <math.h>
+
+#define SIM_DEFAULT_SECONDS 1800
+
+static uint16_t *trace;       // Leituras Q12.4, SENSOR_CHANNEL_COUNT por varredura
+static uint32_t trace_length; // Varreduras na série
+
+static const char *const screen_names[] = {
+    [STATE_SPLASH] = "splash",
+    [STATE_MENU] = "menu",
+    [STATE_MONITOR] = "monitor",
+    [STATE_HISTORY] = "history",
+    [STATE_CONFIG] = "config",
+    [STATE_STATS] = "stats",
+    [STATE_ALERTS] = "alerts",
+    [STATE_DIAG] = "diag",
+};
+
+// Leitura Q12.4 que a tabela do sensor converte na temperatura mais próxima
+static uint16_t adc_from_temperature(temp_centi_t temp)
+{
+    uint32_t low = 0, high = 4095u << 4;
+    bool rising = temperature_from_adc_q4(high) > temperature_from_adc_q4(low);
+    while (low < high)
+    {
+        uint32_t middle = (low + high) / 2;
+        temp_centi_t value = temperature_from_adc_q4(middle);
+        if (rising ? value < temp : value > temp)
+            low = middle + 1;
+        else
+            high = middle;
+    }
+    return low;
+}
+
+// Série sintética: ciclo de 10 min em torno de 35 C, ruído de +-0,3 C e um
+// pico entre 20 e 25 min que passa por atenção e urgência
+static bool synthetic_source(uint32_t scan, uint16_t *adc_q4, uint8_t channels)
+{
+    static uint32_t noise = 12345;
+    for (uint8_t ch = 0; ch < channels; ch++)
+    {
+        noise = noise * 1103515245u + 12345u;
+        float temp = 35.0f + 8.0f * sinf(2.0f * 3.14159265f * scan / 600.0f) +
+                     ((int)(noise >> 16) % 61 - 30) / 100.0f + 1.5f * ch;
+        if (scan >= 1200 && scan < 1500)
+            temp += 35.0f * (scan < 1350 ? (scan - 1200) / 150.0f : (1500 - scan) / 150.0f);
+        adc_q4[ch] = adc_from_temperature(TEMP_CENTI(temp));
+    }
+    return true;
+}
+
+static bool trace_source(uint32_t scan, uint16_t *adc_q4, uint8_t channels)
+{
+    if (scan >= trace_length)
+        return false;
+    memcpy(adc_q4, &trace[scan * SENSOR_CHANNEL_COUNT], channels * sizeof(uint16_t));
+    return true;
+}
+
+// Lê a série: uma linha por varredura; canais que faltam repetem a última coluna
+static bool load_trace(const char *path, bool raw)
+{
+    FILE *file = fopen(path, "r");
+    if (!file)
+    {
+        perror(path);
+        return false;
+    }
+    uint32_t capacity = 0;
+    char line[512];
+    while (fgets(line, sizeof(line), file))
+    {
+        char *comment = strchr(line, '#');
+        if (comment)
+            *comment = '\0';
+        uint16_t values[SENSOR_CHANNEL_COUNT];
+        uint8_t columns = 0;
+        for (char *token = strtok(line, " ,;\t\r\n"); token && columns < SENSOR_CHANNEL_COUNT;
+             token = strtok(NULL, " ,;\t\r\n"))
+        {
+            char *end;
+            double value = strtod(token, &end);
+            if (end == token)
+                continue;
+            values[columns++] = raw ? (uint16_t)value : adc_from_temperature(TEMP_CENTI(value));
+        }
+        if (columns == 0)
+            continue;
+        for (uint8_t ch = columns; ch < SENSOR_CHANNEL_COUNT; ch++)
+            values[ch] = values[columns - 1];
+
+        if (trace_length == capacity)
+        {
+            capacity = capacity ? capacity * 2 : 1024;
+            trace = realloc(trace, (size_t)capacity * SENSOR_CHANNEL_COUNT * sizeof(uint16_t));
+        }
+        memcpy(&trace[trace_length++ * SENSOR_CHANNEL_COUNT], values, sizeof(values));
+    }
+    fclose(file);
+    return trace_length > 0;
+}
+
+static int find_name(const char *name, const char *const *names, int count)
+{
+    for (int i = 0; i < count; i++)
+    {
+        if (names[i] && strcmp(name, names[i]) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static void print_summary(uint32_t minutes)
+{
+    const hal_linux_stats_t *stats = hal_linux_stats();
+    SystemStatus status;
+    status_snapshot(&status);
+    const char *const alert_names[] = {"normal", "attention", "urgent"};
+
+    printf("scans %lu\n", (unsigned long)stats->scans);
+    printf("archive_minutes %lu\n", (unsigned long)minutes);
+    printf("alert %s\n", alert_names[status.current_alert]);
+    printf("led %u %u %u\n", hal_linux_led(LED_R), hal_linux_led(LED_G), hal_linux_led(LED_B));
+    printf("flushes %lu\n", (unsigned long)stats->flushes);
+    printf("flushed_bytes %lu\n", (unsigned long)stats->flushed_bytes);
+    printf("bytes_per_flush %.1f\n", stats->flushes ? (double)stats->flushed_bytes / stats->flushes : 0.0);
+    printf("i2c_words %lu\n", (unsigned long)stats->stream_words);
+
+    for (uint8_t ch = 0; ch < SENSOR_CHANNEL_COUNT; ch++)
+    {
+        char last[TEMP_STR_SIZE], low[TEMP_STR_SIZE], high[TEMP_STR_SIZE], mean[TEMP_STR_SIZE];
+        stream_stats_summary_t summary;
+        if (!stats_snapshot(ch, STATS_TOTAL, &summary))
+            continue;
+        printf("channel %u last %s min %s max %s mean %s\n", ch,
+               temperature_format(last, status.latest_temp[ch], 2),
+               temperature_format(low, summary.min, 2), temperature_format(high, summary.max, 2),
+               temperature_format(mean, summary.mean, 2));
+    }
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t seconds = 0;
+    const char *trace_path = NULL;
+    bool raw = false;
+    int screen = STATE_MONITOR;
+    const char *frames_dir = NULL;
+    uint32_t every = 1;
+    const char *out_path = NULL;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+        if (!value)
+        {
+            fprintf(stderr, "uso: %s [--seconds N] [--trace ARQ | --raw-trace ARQ] [--screen TELA] "
+                            "[--zoom NIVEL] [--channel N] [--frames DIR] [--every N] [--out ARQ]\n",
+                    argv[0]);
+            return 2;
+        }
+        i++;
+        if (strcmp(arg, "--seconds") == 0)
+            seconds = strtoul(value, NULL, 0);
+        else if (strcmp(arg, "--trace") == 0 || strcmp(arg, "--raw-trace") == 0)
+        {
+            trace_path = value;
+            raw = strcmp(arg, "--raw-trace") == 0;
+        }
+        else if (strcmp(arg, "--screen") == 0)
+        {
+            screen = find_name(value, screen_names, count_of(screen_names));
+            if (screen < 0)
+            {
+                fprintf(stderr, "tela invalida: %s\n", value);
+                return 2;
+            }
+        }
+        else if (strcmp(arg, "--zoom") == 0)
+        {
+            int zoom = find_name(value, history_zoom_labels, HISTORY_TIER_COUNT);
+            if (zoom < 0)
+            {
+                fprintf(stderr, "zoom invalido: %s\n", value);
+                return 2;
+            }
+            history_zoom = zoom;
+        }
+        else if (strcmp(arg, "--channel") == 0)
+            selected_channel = strtoul(value, NULL, 0) % SENSOR_CHANNEL_COUNT;
+        else if (strcmp(arg, "--frames") == 0)
+            frames_dir = value;
+        else if (strcmp(arg, "--every") == 0)
+            every = strtoul(value, NULL, 0) ? strtoul(value, NULL, 0) : 1;
+        else if (strcmp(arg, "--out") == 0)
+            out_path = value;
+        else
+        {
+            fprintf(stderr, "opcao desconhecida: %s\n", arg);
+            return 2;
+        }
+    }
+
+    events_init();
+    monitor_init();
+    if (trace_path)
+    {
+        if (!load_trace(trace_path, raw))
+            return 1;
+        hal_linux_set_source(trace_source);
+    }
+    else
+    {
+        hal_linux_set_source(synthetic_source);
+        if (seconds == 0)
+            seconds = SIM_DEFAULT_SECONDS;
+    }
+
+    const hal_display_config_t display_config = {.i2c = I2C_PORT, .address = DISPLAY_ADDR};
+    ssd1306_t ssd;
+    hal_display_init(&ssd, &display_config, NULL, NULL);
+    hal_button_init(BUTTON_A_PIN, gpio_callback);
+    hal_button_init(BUTTON_B_PIN, gpio_callback);
+
+    // A tela pedida já aberta, como se o menu tivesse levado até ela
+    current_state = screen;
+    if (screen > STATE_MENU)
+        selected_menu_item = screen - STATE_MONITOR;
+    hal_sensors_start(&sensor_config, temperature_scan_done);
+
+    // Mesmo ciclo do laço do firmware, um passo por varredura
+    uint32_t minutes = 0;
+    for (uint32_t step = 0; seconds == 0 || step < seconds; step++)
+    {
+        if (!hal_linux_advance_ms(TEMP_READ_INTERVAL_MS))
+            break;
+
+        SampleRecord record;
+        while (spsc_ring_pop(&sample_ring, &record))
+            new_temperature_available = true;
+        ArchiveRecord archive;
+        while (spsc_ring_pop(&archive_ring, &archive))
+            minutes++;
+        handle_buttons();
+        update_splash();
+
+        draw_current_screen(&ssd);
+        if (hal_display_flush(&ssd) && frames_dir && step % every == 0)
+        {
+            char path[512];
+            snprintf(path, sizeof(path), "%s/frame_%06lu.pbm", frames_dir, (unsigned long)step + 1);
+            if (!hal_linux_write_pbm(path))
+            {
+                perror(path);
+                return 1;
+            }
+        }
+    }
+
+    if (out_path && !hal_linux_write_pbm(out_path))
+    {
+        perror(out_path);
+        return 1;
+    }
+    print_summary(minutes);
+    return 0;
+}
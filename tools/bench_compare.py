@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+"""Compara dois resultados dos benchmarks do desenho (bench/).
+
+Cada arquivo tem uma linha JSON por caso, como sai do monitor_bench no PC
+ou da porta USB da placa (linhas que não são JSON são ignoradas):
+
+  build-sim/monitor_bench > novo.jsonl
+  bench_compare.py base.jsonl novo.jsonl
+  bench_compare.py base.jsonl novo.jsonl --threshold 5
+
+Mostra ns/op e bytes por quadro lado a lado e marca os casos que pioraram
+mais que o limite (em %) ou que passaram a enviar mais bytes. Sai com
+código 1 se houver alguma regressão, para uso em scripts.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    results = {}
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if not line.startswith("{"):
+                continue
+            try:
+                entry = json.loads(line)
+            except ValueError:
+                continue
+            results[entry["bench"]] = entry
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("base")
+    parser.add_argument("new")
+    parser.add_argument("--threshold", type=float, default=10.0,
+                        help="piora tolerada em ns/op, em %% (padrao 10)")
+    args = parser.parse_args()
+
+    base = load(args.base)
+    new = load(args.new)
+    platforms = {e["platform"] for e in base.values()} | {e["platform"] for e in new.values()}
+    if len(platforms) > 1:
+        print("aviso: plataformas diferentes: %s" % ", ".join(sorted(platforms)), file=sys.stderr)
+
+    regressions = 0
+    print("%-28s %10s %10s %8s %7s %7s" % ("caso", "base ns", "novo ns", "delta", "bytes", "novo"))
+    for name in list(base) + [n for n in new if n not in base]:
+        old, cur = base.get(name), new.get(name)
+        if old is None or cur is None:
+            print("%-28s %s" % (name, "so no novo" if old is None else "so na base"))
+            continue
+        delta = (cur["ns_per_op"] - old["ns_per_op"]) / old["ns_per_op"] * 100 if old["ns_per_op"] else 0.0
+        old_bytes, cur_bytes = old.get("flush_bytes"), cur.get("flush_bytes")
+        flag = ""
+        if delta > args.threshold:
+            flag = " <- mais lento"
+        if old_bytes is not None and cur_bytes is not None and cur_bytes > old_bytes:
+            flag += " <- mais bytes"
+        regressions += bool(flag)
+        print("%-28s %10.1f %10.1f %+7.1f%% %7s %7s%s" % (
+            name, old["ns_per_op"], cur["ns_per_op"], delta,
+            "-" if old_bytes is None else old_bytes,
+            "-" if cur_bytes is None else cur_bytes, flag))
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
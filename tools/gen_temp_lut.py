@@ -0,0 +1,111 @@
+#!/usr/bin/env python3
+"""Gera a tabela de conversão ADC -> temperatura usada por lib/temperature.c.
+
+A tabela tem 257 entradas em centésimos de grau, uma a cada 16 contagens do
+ADC de 12 bits (256 unidades em Q12.4); o firmware interpola linearmente entre
+entradas vizinhas. Modelos de sensor suportados:
+
+  linear     Tensão proporcional à temperatura (--t-min em 0, --t-max em 4095)
+  beta       NTC pela equação Beta (--r0 a --t0, --beta)
+  steinhart  NTC por Steinhart-Hart (--sh-a, --sh-b, --sh-c)
+
+Para os NTC o divisor é alimentado pela mesma referência do ADC; com
+--ntc-position low o NTC fica entre o ADC e o GND e --r-series entre o ADC e
+3V3 (com high, o inverso).
+"""
+
+import argparse
+import math
+
+ENTRIES = 257
+ADC_FULL_SCALE = 4095
+STEP = 16  # contagens do ADC por entrada
+KELVIN = 273.15
+
+
+def ntc_resistance(ratio, args):
+    if args.ntc_position == "low":
+        if ratio >= 1.0:
+            return math.inf
+        return args.r_series * ratio / (1.0 - ratio)
+    if ratio <= 0.0:
+        return math.inf
+    return args.r_series * (1.0 - ratio) / ratio
+
+
+def temperature(adc, args):
+    # A última entrada (4096) fica além do fundo de escala; a reta é estendida
+    # para que a interpolação em 4095 caia exatamente em --t-max
+    ratio = adc / ADC_FULL_SCALE
+    if args.model == "linear":
+        return args.t_min + ratio * (args.t_max - args.t_min)
+
+    r = ntc_resistance(min(ratio, 1.0), args)
+    if r == 0.0:
+        return math.inf   # Curto: temperatura acima de qualquer limite
+    if math.isinf(r):
+        return -math.inf  # Aberto: abaixo de qualquer limite
+    ln_r = math.log(r)
+    if args.model == "beta":
+        inv_t = 1.0 / (args.t0 + KELVIN) + (ln_r - math.log(args.r0)) / args.beta
+    else:
+        inv_t = args.sh_a + args.sh_b * ln_r + args.sh_c * ln_r ** 3
+    return 1.0 / inv_t - KELVIN
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--model", choices=("linear", "beta", "steinhart"), default="linear")
+    parser.add_argument("--out", required=True)
+    parser.add_argument("--t-min", type=float, default=0.0)
+    parser.add_argument("--t-max", type=float, default=100.0)
+    parser.add_argument("--r-series", type=float, default=10000.0)
+    parser.add_argument("--ntc-position", choices=("low", "high"), default="low")
+    parser.add_argument("--r0", type=float, default=10000.0)
+    parser.add_argument("--t0", type=float, default=25.0)
+    parser.add_argument("--beta", type=float, default=3950.0)
+    parser.add_argument("--sh-a", type=float, default=1.009249522e-03)
+    parser.add_argument("--sh-b", type=float, default=2.378405444e-04)
+    parser.add_argument("--sh-c", type=float, default=2.019202697e-07)
+    parser.add_argument("--clamp-min", type=float, default=-55.0)
+    parser.add_argument("--clamp-max", type=float, default=150.0)
+    args = parser.parse_args()
+
+    values = []
+    for i in range(ENTRIES):
+        t = temperature(i * STEP, args)
+        t = min(max(t, args.clamp_min), args.clamp_max)
+        values.append(int(round(t * 100.0)))
+
+    if args.model == "linear":
+        params = "t_min=%g t_max=%g" % (args.t_min, args.t_max)
+    elif args.model == "beta":
+        params = "r0=%g t0=%g beta=%g r_series=%g ntc=%s" % (
+            args.r0, args.t0, args.beta, args.r_series, args.ntc_position)
+    else:
+        params = "a=%g b=%g c=%g r_series=%g ntc=%s" % (
+            args.sh_a, args.sh_b, args.sh_c, args.r_series, args.ntc_position)
+
+    lines = [
+        "// Gerado por tools/gen_temp_lut.py - não edite",
+        "// Modelo: %s (%s)" % (args.model, params),
+        "#ifndef TEMP_LUT_H",
+        "#define TEMP_LUT_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define TEMP_LUT_ENTRIES %d" % ENTRIES,
+        "",
+        "static const int16_t temp_lut_model[TEMP_LUT_ENTRIES] = {",
+    ]
+    for row in range(0, ENTRIES, 8):
+        lines.append("    " + " ".join("%d," % v for v in values[row:row + 8]))
+    lines += ["};", "", "#endif // TEMP_LUT_H", ""]
+
+    with open(args.out, "w", encoding="utf-8") as out:
+        out.write("\n".join(lines))
+
+
+if __name__ == "__main__":
+    main()
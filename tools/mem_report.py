@@ -0,0 +1,193 @@
+#!/usr/bin/env python3
+"""Uso de flash e RAM por módulo, a partir do mapa do linker.
+
+O build do firmware roda este script depois de cada link (CMakeLists.txt),
+sobre o System_Monitor_Temp_PV.elf.map gerado pelo SDK:
+
+  mem_report.py build/System_Monitor_Temp_PV.elf.map
+  mem_report.py build/System_Monitor_Temp_PV.elf.map --json > mem.json
+  mem_report.py build/System_Monitor_Temp_PV.elf.map --top 10
+
+Cada seção de entrada conta na região da memória onde roda (VMA) e, se a
+seção de saída tem endereço de carga em outra região, também na flash: com
+copy_to_ram o código ocupa as duas. Os módulos são os .c da aplicação
+(lib/ssd1306.c -> ssd1306), os componentes do SDK (sdk:hardware_i2c) e as
+bibliotecas do compilador (libc_nano). Sem regiões no mapa (build do
+simulador), a classificação cai para o nome da seção.
+
+O heap e o uso real das pilhas só existem em execução: veja o comando "mem"
+do firmware (lib/mem_usage.h).
+"""
+
+import argparse
+import json
+import os
+import re
+import sys
+from collections import defaultdict
+
+SKIP_SECTIONS = re.compile(r"^\.(debug|comment|ARM\.attributes|note|stab|gnu_debug)")
+OUTPUT_LINE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?")
+OUTPUT_TAIL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)(?:\s+load address 0x([0-9a-fA-F]+))?\s*$")
+INPUT_LINE = re.compile(r"^ (\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+INPUT_TAIL = re.compile(r"^\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$")
+REGION_LINE = re.compile(r"^(\S+)\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)")
+SDK_PATH = re.compile(r"/src/(?:rp2_common|common|rp2040|host)/([^/]+)/")
+
+
+def module_name(path):
+    """Agrupa o arquivo objeto no módulo que o relatório mostra."""
+    archive = re.match(r"(.*\.a)\((.*)\)$", path)
+    if archive:
+        name = os.path.basename(archive.group(1))
+        return name[:-2]
+    sdk = SDK_PATH.search(path)
+    if sdk:
+        return "sdk:" + sdk.group(1)
+    name = os.path.basename(path)
+    for suffix in (".c.obj", ".S.obj", ".c.o", ".S.o", ".obj", ".o"):
+        if name.endswith(suffix):
+            return name[: -len(suffix)]
+    return name
+
+
+def parse(path):
+    regions = []
+    sections = []  # (nome, vma, tamanho, carga da seção de saída, módulo)
+    state = "start"
+    pending_output = pending_input = None
+    load_delta = None  # Carga - VMA da seção de saída atual
+
+    with open(path, errors="replace") as f:
+        for line in f:
+            line = line.rstrip("\n")
+            if state == "start":
+                if line.startswith("Memory Configuration"):
+                    state = "regions"
+                continue
+            if state == "regions":
+                if line.startswith("Linker script and memory map"):
+                    state = "map"
+                    continue
+                m = REGION_LINE.match(line)
+                if m and m.group(1) not in ("Name", "*default*"):
+                    regions.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16)))
+                continue
+
+            # Seção de saída (coluna 0), às vezes com endereço na linha seguinte
+            if pending_output is not None:
+                m = OUTPUT_TAIL.match(line)
+                if m:
+                    vma = int(m.group(1), 16)
+                    load_delta = int(m.group(3), 16) - vma if m.group(3) else None
+                pending_output = None
+                if m:
+                    continue
+            if line and not line[0].isspace():
+                m = OUTPUT_LINE.match(line)
+                if m:
+                    vma = int(m.group(2), 16)
+                    load_delta = int(m.group(4), 16) - vma if m.group(4) else None
+                elif re.match(r"^\S+$", line):
+                    pending_output = line
+                    load_delta = None
+                continue
+
+            # Seção de entrada (uma coluna de recuo), idem
+            if pending_input is not None:
+                m = INPUT_TAIL.match(line)
+                name, pending_input = pending_input, None
+                if m:
+                    sections.append((name, int(m.group(1), 16), int(m.group(2), 16), load_delta,
+                                     module_name(m.group(3).strip())))
+                    continue
+            m = INPUT_LINE.match(line)
+            if m:
+                if m.group(1) in ("*fill*",):
+                    continue
+                sections.append((m.group(1), int(m.group(2), 16), int(m.group(3), 16), load_delta,
+                                 module_name(m.group(4).strip())))
+                continue
+            m = re.match(r"^ (\.\S+|COMMON)$", line)
+            if m:
+                pending_input = m.group(1)
+
+    return regions, sections
+
+
+def region_of(regions, address):
+    for name, origin, length in regions:
+        if origin <= address < origin + length:
+            return name
+    return None
+
+
+def classify(regions, sections):
+    """Bytes por módulo e por região; sem regiões, flash/ram pelo nome da seção."""
+    usage = defaultdict(lambda: defaultdict(int))
+    for name, vma, size, load_delta, module in sections:
+        if size == 0 or SKIP_SECTIONS.match(name):
+            continue
+        if regions:
+            region = region_of(regions, vma)
+            if region is None:
+                continue
+            usage[module][region] += size
+            if load_delta:
+                load_region = region_of(regions, vma + load_delta)
+                if load_region and load_region != region:
+                    usage[module][load_region] += size
+        else:
+            if name.startswith((".bss", "COMMON", ".tbss")):
+                usage[module]["RAM"] += size
+            elif name.startswith((".data", ".tdata")):
+                usage[module]["RAM"] += size
+                usage[module]["FLASH"] += size
+            elif name.startswith((".text", ".rodata", ".init", ".fini", ".eh_frame", ".gcc_except")):
+                usage[module]["FLASH"] += size
+    return usage
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("map")
+    parser.add_argument("--json", action="store_true", help="saida em JSON")
+    parser.add_argument("--top", type=int, default=0, help="so os N maiores modulos em RAM")
+    args = parser.parse_args()
+
+    regions, sections = parse(args.map)
+    usage = classify(regions, sections)
+    columns = [r[0] for r in regions] or ["FLASH", "RAM"]
+    capacity = {name: length for name, _, length in regions}
+
+    # RAM total: SRAM principal mais os bancos de rascunho (pilhas)
+    ram_columns = [c for c in columns if c == "RAM" or c.startswith("SCRATCH")]
+    modules = sorted(usage, key=lambda m: -sum(usage[m][c] for c in ram_columns))
+    totals = {c: sum(usage[m][c] for m in usage) for c in columns}
+
+    if args.json:
+        json.dump({
+            "regions": {name: {"origin": origin, "length": length, "used": totals.get(name, 0)}
+                        for name, origin, length in regions},
+            "modules": {m: dict(usage[m]) for m in modules},
+        }, sys.stdout, indent=1)
+        print()
+        return 0
+
+    shown = modules[: args.top] if args.top else modules
+    print("%-28s" % "modulo" + "".join("%11s" % c for c in columns))
+    for m in shown:
+        print("%-28s" % m + "".join("%11d" % usage[m][c] for c in columns))
+    if len(shown) < len(modules):
+        rest = modules[len(shown):]
+        print("%-28s" % ("(mais %d)" % len(rest)) +
+              "".join("%11d" % sum(usage[m][c] for m in rest) for c in columns))
+    print("%-28s" % "total" + "".join("%11d" % totals[c] for c in columns))
+    if capacity:
+        print("%-28s" % "capacidade" + "".join("%11d" % capacity[c] for c in columns))
+        print("%-28s" % "uso" + "".join("%10.1f%%" % (100.0 * totals[c] / capacity[c]) for c in columns))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
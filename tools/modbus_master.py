@@ -0,0 +1,269 @@
+#!/usr/bin/env python3
+"""Mestre Modbus RTU de teste para o escravo do firmware (lib/modbus_rtu.h).
+
+Lê o mapa de registradores, altera limites e seleção do histórico e mede a
+latência das respostas com pedidos seguidos, sem pausa entre eles:
+
+  modbus_master.py --port /dev/ttyUSB0 dump
+  modbus_master.py --port /dev/ttyUSB0 history 0 1      # canal 0, nível 1 min
+  modbus_master.py --port /dev/ttyUSB0 thresholds 45 65 80
+  modbus_master.py --port /dev/ttyUSB0 poll --count 1000
+
+A latência medida aqui vai do fim do envio do pedido ao último byte da
+resposta e inclui o adaptador USB-serial; o firmware mede a sua parte (do
+último byte do pedido ao início da resposta) e mostra no comando "modbus".
+"""
+
+import argparse
+import os
+import select
+import struct
+import sys
+import time
+
+CHANNEL_BASE = 0x0100
+CHANNEL_STRIDE = 0x20
+CHANNEL_REGS = 27
+HISTORY_BASE = 0x1000
+HISTORY_RECORDS = 128
+NO_DATA = -0x8000
+
+WINDOWS = ("1min", "15min", "1h", "total")
+ALERTS = ("normal", "atencao", "urgente")
+TIERS = ("1s", "1m", "15m", "1h")
+
+EXCEPTIONS = {1: "funcao ilegal", 2: "endereco ilegal", 3: "valor ilegal"}
+
+
+class ModbusError(Exception):
+    pass
+
+
+def crc16_modbus(data):
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0xA001 if crc & 1 else 0)
+    return crc
+
+
+def adu(address, pdu):
+    frame = bytes([address]) + pdu
+    return frame + struct.pack("<H", crc16_modbus(frame))
+
+
+def signed(value):
+    return value - 0x10000 if value & 0x8000 else value
+
+
+def centi(value):
+    return "--" if value == NO_DATA else "%.2f" % (value / 100.0)
+
+
+class Port:
+    """Porta serial crua (pyserial se disponível, senão termios)."""
+
+    def __init__(self, path, baudrate, parity):
+        self.char_time = 11.0 / baudrate
+        try:
+            import serial
+            self.serial = serial.Serial(path, baudrate, parity=parity, timeout=0,
+                                        stopbits=1 if parity != "N" else 2)
+            self.fd = self.serial.fileno()
+        except ImportError:
+            import termios
+            import tty
+            self.serial = None
+            self.fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+            tty.setraw(self.fd)
+            attrs = termios.tcgetattr(self.fd)
+            speed = getattr(termios, "B%d" % baudrate)
+            attrs[4] = attrs[5] = speed
+            attrs[2] &= ~(termios.PARENB | termios.PARODD | termios.CSTOPB)
+            if parity == "E":
+                attrs[2] |= termios.PARENB
+            elif parity == "O":
+                attrs[2] |= termios.PARENB | termios.PARODD
+            else:
+                attrs[2] |= termios.CSTOPB
+            try:
+                termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+            except termios.error:
+                # Pseudo-terminais (simulação) não aceitam paridade
+                sys.stderr.write("aviso: %s sem paridade\n" % path)
+                attrs[2] &= ~(termios.PARENB | termios.PARODD)
+                termios.tcsetattr(self.fd, termios.TCSANOW, attrs)
+            termios.tcflush(self.fd, termios.TCIOFLUSH)
+
+    def write(self, data):
+        os.write(self.fd, data)
+        try:
+            import termios
+            termios.tcdrain(self.fd)
+        except (ImportError, OSError):
+            pass
+
+    def read(self, length, deadline):
+        data = b""
+        while len(data) < length:
+            remaining = deadline - time.monotonic()
+            if remaining <= 0 or not select.select([self.fd], [], [], remaining)[0]:
+                break
+            data += os.read(self.fd, length - len(data))
+        return data
+
+    def drain_input(self):
+        while select.select([self.fd], [], [], 0)[0]:
+            if not os.read(self.fd, 256):
+                break
+
+
+class Master:
+    def __init__(self, port, address, timeout):
+        self.port = port
+        self.address = address
+        self.timeout = timeout
+        self.last_latency = 0.0
+
+    def request(self, pdu, expected):
+        """Envia um pedido e devolve o PDU da resposta (sem endereço e CRC)."""
+        # Silêncio de 3,5 caracteres antes do pedido, como pede a norma
+        time.sleep(max(3.5 * self.port.char_time, 0.00175))
+        self.port.drain_input()
+        self.port.write(adu(self.address, pdu))
+        start = time.monotonic()
+        deadline = start + self.timeout
+
+        head = self.port.read(2, deadline)
+        if len(head) < 2:
+            raise ModbusError("sem resposta")
+        length = 5 if head[1] & 0x80 else expected + 3
+        frame = head + self.port.read(length - 2, deadline)
+        self.last_latency = time.monotonic() - start
+        if len(frame) < length:
+            raise ModbusError("resposta incompleta (%d de %d bytes)" % (len(frame), length))
+        if crc16_modbus(frame) != 0:
+            raise ModbusError("CRC errado")
+        if frame[0] != self.address or frame[1] & 0x7F != pdu[0]:
+            raise ModbusError("resposta de outro pedido")
+        if frame[1] & 0x80:
+            code = frame[2]
+            raise ModbusError("excecao %d (%s)" % (code, EXCEPTIONS.get(code, "?")))
+        return frame[1:-2]
+
+    def read_registers(self, function, address, count):
+        pdu = self.request(struct.pack(">BHH", function, address, count), 2 + 2 * count)
+        if pdu[1] != 2 * count:
+            raise ModbusError("tamanho errado")
+        return list(struct.unpack(">%dH" % count, pdu[2:]))
+
+    def read_input(self, address, count):
+        return self.read_registers(0x04, address, count)
+
+    def read_holding(self, address, count):
+        return self.read_registers(0x03, address, count)
+
+    def write_single(self, address, value):
+        self.request(struct.pack(">BHH", 0x06, address, value & 0xFFFF), 5)
+
+    def write_multiple(self, address, values):
+        payload = struct.pack(">%dH" % len(values), *(v & 0xFFFF for v in values))
+        self.request(struct.pack(">BHHB", 0x10, address, len(values), len(payload)) + payload, 5)
+
+
+def read_history(master, channel, tier):
+    master.write_multiple(0x0010, [channel, tier])
+    total = master.read_input(0x0004, 1)[0]
+    records = []
+    # Até 41 registros (123 registradores) por leitura
+    for first in range(0, total, 41):
+        count = min(41, total - first)
+        values = [signed(v) for v in master.read_input(HISTORY_BASE + 3 * first, 3 * count)]
+        records += [values[i:i + 3] for i in range(0, len(values), 3)]
+    return records
+
+
+def dump(master, out):
+    general = master.read_input(0x0000, 5)
+    channels = general[0]
+    out.write("%d canais, alerta %s, %d varreduras\n" %
+              (channels, ALERTS[general[1]] if general[1] < len(ALERTS) else general[1],
+               (general[2] << 16) | general[3]))
+    for ch in range(channels):
+        regs = master.read_input(CHANNEL_BASE + CHANNEL_STRIDE * ch, CHANNEL_REGS)
+        alert = ALERTS[regs[2]] if regs[2] < len(ALERTS) else regs[2]
+        out.write("canal %d: %s C, adc %.2f, %s\n" % (ch, centi(signed(regs[0])), regs[1] / 16.0, alert))
+        for w, name in enumerate(WINDOWS):
+            low, high, mean, stddev, count_hi, count_lo = regs[3 + 6 * w:9 + 6 * w]
+            out.write("  %-5s min %s max %s media %s desvio %s (%d amostras)\n" %
+                      (name, centi(signed(low)), centi(signed(high)), centi(signed(mean)),
+                       centi(stddev), (count_hi << 16) | count_lo))
+    normal, attention, urgent = (signed(v) for v in master.read_holding(0x0000, 3))
+    out.write("limites: normal %s, atencao %s, urgente %s C\n" %
+              (centi(normal), centi(attention), centi(urgent)))
+
+
+def poll(master, count, out):
+    """Pedidos seguidos, misturando os tipos; resume a latência."""
+    requests = (
+        lambda: master.read_input(0x0000, 5),
+        lambda: master.read_input(CHANNEL_BASE, CHANNEL_REGS),
+        lambda: master.read_input(HISTORY_BASE, 120),
+        lambda: master.read_holding(0x0000, 3),
+    )
+    latencies, failures = [], {}
+    for i in range(count):
+        try:
+            requests[i % len(requests)]()
+            latencies.append(master.last_latency)
+        except ModbusError as error:
+            failures[str(error)] = failures.get(str(error), 0) + 1
+    if latencies:
+        latencies.sort()
+        out.write("%d respostas: min %.2f ms, mediana %.2f ms, p99 %.2f ms, max %.2f ms\n" %
+                  (len(latencies), latencies[0] * 1e3, latencies[len(latencies) // 2] * 1e3,
+                   latencies[min(len(latencies) - 1, len(latencies) * 99 // 100)] * 1e3,
+                   latencies[-1] * 1e3))
+    for error, n in sorted(failures.items()):
+        out.write("%d falhas: %s\n" % (n, error))
+    return not failures
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", required=True, help="porta serial ligada à UART do escravo")
+    parser.add_argument("--baud", type=int, default=19200)
+    parser.add_argument("--parity", choices="NEO", default="E")
+    parser.add_argument("--address", type=int, default=1)
+    parser.add_argument("--timeout", type=float, default=0.2, help="espera por resposta (s)")
+    sub = parser.add_subparsers(dest="command", required=True)
+    sub.add_parser("dump")
+    history = sub.add_parser("history")
+    history.add_argument("channel", type=int)
+    history.add_argument("tier", type=int)
+    thresholds = sub.add_parser("thresholds")
+    thresholds.add_argument("limits", type=float, nargs=3, metavar=("NORMAL", "ATENCAO", "URGENTE"))
+    polling = sub.add_parser("poll")
+    polling.add_argument("--count", type=int, default=1000)
+    args = parser.parse_args()
+
+    master = Master(Port(args.port, args.baud, args.parity), args.address, args.timeout)
+    try:
+        if args.command == "dump":
+            dump(master, sys.stdout)
+        elif args.command == "history":
+            for age, (low, high, mean) in enumerate(read_history(master, args.channel, args.tier)):
+                print("%d: %s/%s/%s" % (age, centi(low), centi(high), centi(mean)))
+        elif args.command == "thresholds":
+            master.write_multiple(0x0000, [round(t * 100) for t in args.limits])
+            dump(master, sys.stdout)
+        elif args.command == "poll":
+            sys.exit(0 if poll(master, args.count, sys.stdout) else 1)
+    except ModbusError as error:
+        sys.exit("erro: %s" % error)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,163 @@
+#!/usr/bin/env python3
+"""Mostra no terminal o espelho do display OLED (lib/display_mirror.h).
+
+Liga o modo binário e o espelho pela porta USB e redesenha a imagem de
+128x64 com meio-blocos a cada quadro completo; também lê uma captura do
+fluxo binário (arquivo ou entrada padrão):
+
+  oled_mirror.py --port /dev/ttyACM0
+  oled_mirror.py --port /dev/ttyACM0 --pbm /tmp/tela.pbm
+  oled_mirror.py captura.bin --pbm /tmp/tela.pbm
+
+Cada quadro traz só as colunas que mudaram, em XOR com a imagem anterior e
+comprimidas em PackBits. Se um quadro se perde a imagem fica marcada como
+desatualizada e, com --port, o script religa o espelho para receber um
+quadro-chave. As demais mensagens do protocolo são ignoradas.
+"""
+
+import argparse
+import os
+import struct
+import sys
+import time
+
+from stream_decode import CMD_MIRROR, CMD_STOP, MSG_MIRROR, frame_decode, frame_encode, open_port
+
+COLUMNS = 128
+PAGES = 8
+HEADER = struct.Struct("<HB")
+FLAG_KEY = 0x01
+FLAG_SYNCED = 0x02
+
+
+def unpackbits(data, offset, count):
+    """Decodifica `count` bytes de PackBits a partir de `offset`."""
+    out = bytearray()
+    while len(out) < count:
+        n = data[offset]
+        offset += 1
+        if n < 128:
+            out += data[offset:offset + n + 1]
+            offset += n + 1
+        elif n > 128:
+            out += bytes([data[offset]]) * (257 - n)
+            offset += 1
+    if len(out) != count:
+        raise ValueError("trecho maior que o declarado")
+    return bytes(out), offset
+
+
+class Mirror:
+    def __init__(self):
+        self.image = bytearray(COLUMNS * PAGES)
+        self.sequence = None
+        self.valid = False  # Imagem igual à do display
+        self.bytes = 0
+
+    def apply(self, payload):
+        """Aplica um quadro; devolve verdadeiro quando a imagem fica completa."""
+        sequence, flags = HEADER.unpack_from(payload)
+        self.bytes += len(payload)
+        if flags & FLAG_KEY:
+            self.image = bytearray(COLUMNS * PAGES)
+            self.valid = True
+        elif self.sequence is None or sequence != (self.sequence + 1) & 0xFFFF:
+            self.valid = False
+        self.sequence = sequence
+
+        offset = HEADER.size
+        while offset < len(payload):
+            x0, columns = payload[offset], payload[offset + 1]
+            delta, offset = unpackbits(payload, offset + 2, columns * PAGES)
+            start = x0 * PAGES
+            for i, byte in enumerate(delta):
+                self.image[start + i] ^= byte
+        return self.valid and bool(flags & FLAG_SYNCED)
+
+    def pixel(self, x, y):
+        return (self.image[x * PAGES + (y >> 3)] >> (y & 7)) & 1
+
+    def render(self):
+        """Duas linhas do display por linha do terminal."""
+        blocks = (" ", "▀", "▄", "█")
+        rows = []
+        for y in range(0, PAGES * 8, 2):
+            rows.append("".join(blocks[self.pixel(x, y) | (self.pixel(x, y + 1) << 1)]
+                                for x in range(COLUMNS)))
+        return rows
+
+    def write_pbm(self, path):
+        rows = [" ".join(str(self.pixel(x, y)) for x in range(COLUMNS)) for y in range(PAGES * 8)]
+        tmp = path + ".tmp"
+        with open(tmp, "w") as f:
+            f.write("P1\n%d %d\n%s\n" % (COLUMNS, PAGES * 8, "\n".join(rows)))
+        os.replace(tmp, path)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", help="arquivo capturado (padrão: entrada padrão)")
+    parser.add_argument("--port", help="porta serial do dispositivo")
+    parser.add_argument("--pbm", help="grava cada imagem completa neste arquivo PBM")
+    parser.add_argument("--quiet", action="store_true", help="não desenha no terminal")
+    args = parser.parse_args()
+
+    if args.port:
+        stream = open_port(args.port)
+        stream.write(b"\nstream\n" + frame_encode(CMD_MIRROR, b"\x01"))
+    elif args.input:
+        stream = open(args.input, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    mirror = Mirror()
+    pending = b""
+    started = time.monotonic()
+    requested = started  # Último pedido de quadro-chave
+    frames = 0
+    try:
+        while True:
+            data = stream.read(256) if args.port else stream.read(4096)
+            if not data:
+                if args.port:
+                    continue
+                break
+            pending += data
+            while b"\x00" in pending:
+                encoded, pending = pending.split(b"\x00", 1)
+                frame = frame_decode(encoded) if encoded else None
+                if frame is None or frame[0] != MSG_MIRROR:
+                    continue
+                frames += 1
+                try:
+                    complete = mirror.apply(frame[1])
+                except (ValueError, IndexError, struct.error):
+                    mirror.valid = False
+                    complete = False
+                if not mirror.valid and args.port and time.monotonic() - requested > 1.0:
+                    stream.write(frame_encode(CMD_MIRROR, b"\x01"))
+                    requested = time.monotonic()
+                if not complete:
+                    continue
+                if args.pbm:
+                    mirror.write_pbm(args.pbm)
+                if not args.quiet:
+                    elapsed = max(time.monotonic() - started, 1e-3)
+                    sys.stdout.write("\x1b[H\x1b[2J" + "\n".join(mirror.render()) +
+                                     "\nquadro %d, %d quadros, %.0f B/s\n" %
+                                     (mirror.sequence, frames, mirror.bytes / elapsed))
+                    sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.port:
+            stream.write(frame_encode(CMD_MIRROR, b"\x00") + frame_encode(CMD_STOP))
+
+    if not args.port:
+        print("%d quadros do espelho, %d bytes" % (frames, mirror.bytes))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
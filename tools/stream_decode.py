@@ -0,0 +1,312 @@
+#!/usr/bin/env python3
+"""Decodifica o protocolo binário da USB (lib/usb_stream.h).
+
+Lê quadros COBS de um arquivo, da entrada padrão (um pipe) ou de uma porta
+serial e imprime uma linha por mensagem. Com --port o script manda o comando
+de texto "stream" para ligar o modo binário e, se pedido, um download:
+
+  stream_decode.py --port /dev/ttyACM0
+  stream_decode.py --port /dev/ttyACM0 --history 0 1   # canal 0, nível 1 min
+  stream_decode.py --port /dev/ttyACM0 --archive
+  stream_decode.py captura.bin
+  cat /tmp/fifo | stream_decode.py
+
+As páginas do arquivo na flash chegam comprimidas (lib/series_codec) e são
+decodificadas aqui. Os quadros do espelho do display aparecem só resumidos;
+tools/oled_mirror.py reconstrói a imagem.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MSG_INFO = 0x01
+MSG_SAMPLE = 0x02
+MSG_STATS = 0x03
+MSG_ALERT = 0x04
+MSG_HISTORY = 0x05
+MSG_ARCHIVE = 0x06
+MSG_END = 0x07
+MSG_STATUS = 0x08
+MSG_MIRROR = 0x09
+
+CMD_STOP = 0x80
+CMD_HISTORY = 0x81
+CMD_ARCHIVE = 0x82
+CMD_MIRROR = 0x83
+
+TIERS = ("1s", "1m", "15m", "1h")
+WINDOWS = ("1min", "15min", "1h", "total")
+ALERTS = ("normal", "atencao", "urgente")
+
+FLASH_LOG_MAGIC = 0x474F4C54
+FLASH_LOG_VERSION = 2
+PAGE_HEADER = struct.Struct("<IIIIHBB")
+
+# (prefixo, bits do prefixo, bits do valor), como em lib/series_codec.c
+BUCKETS = ((0x0, 1, 0), (0x2, 2, 3), (0x6, 3, 6), (0xE, 4, 9), (0xF, 4, 17))
+
+
+def crc16_ccitt(data, crc=0xFFFF):
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def crc32(data):
+    crc = 0xFFFFFFFF
+    for byte in data:
+        crc ^= byte
+        for _ in range(8):
+            crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1))
+    return ~crc & 0xFFFFFFFF
+
+
+def cobs_encode(data):
+    out = bytearray([0])
+    code_index, code = 0, 1
+    for byte in data:
+        if byte:
+            out.append(byte)
+            code += 1
+        if not byte or code == 0xFF:
+            out[code_index] = code
+            code_index, code = len(out), 1
+            out.append(0)
+    out[code_index] = code
+    return bytes(out)
+
+
+def cobs_decode(data):
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        i += 1
+        if code == 0 or i + code - 1 > len(data):
+            return None
+        out += data[i:i + code - 1]
+        i += code - 1
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def frame_encode(msg_type, payload=b""):
+    raw = struct.pack("<BH", msg_type, len(payload)) + payload
+    raw += struct.pack("<H", crc16_ccitt(raw))
+    return cobs_encode(raw) + b"\x00"
+
+
+def frame_decode(encoded):
+    raw = cobs_decode(encoded)
+    if raw is None or len(raw) < 5:
+        return None
+    msg_type, length = struct.unpack_from("<BH", raw)
+    if length != len(raw) - 5:
+        return None
+    if struct.unpack_from("<H", raw, len(raw) - 2)[0] != crc16_ccitt(raw[:-2]):
+        return None
+    return msg_type, raw[3:-2]
+
+
+def centi(value):
+    return "%.2f" % (value / 100.0)
+
+
+class BitReader:
+    def __init__(self, data):
+        self.data = data
+        self.bit = 0
+
+    def read(self, bits):
+        value = 0
+        for _ in range(bits):
+            byte = self.data[self.bit >> 3]
+            value = (value << 1) | ((byte >> (7 - (self.bit & 7))) & 1)
+            self.bit += 1
+        return value
+
+
+def decode_series(payload, fields, count):
+    """Gera os registros de um bloco de lib/series_codec."""
+    reader = BitReader(payload)
+    previous = [0] * fields
+    for position in range(count):
+        values = []
+        for i in range(fields):
+            if position == 0:
+                value = reader.read(16)
+                value -= (value & 0x8000) << 1
+            else:
+                index = 0
+                while index < len(BUCKETS) - 1 and reader.read(1):
+                    index += 1
+                bits = BUCKETS[index][2]
+                delta = 0
+                if bits:
+                    delta = reader.read(bits)
+                    delta -= (delta & (1 << (bits - 1))) << 1
+                value = (previous[i] + delta + 0x8000) % 0x10000 - 0x8000
+            previous[i] = value
+            values.append(value)
+        yield values
+
+
+def describe_archive_page(page):
+    crc, magic, sequence, first, count, fields, version = PAGE_HEADER.unpack_from(page)
+    if magic != FLASH_LOG_MAGIC or version != FLASH_LOG_VERSION or crc != crc32(page[4:]):
+        return ["ARCHIVE pagina invalida"]
+    lines = ["ARCHIVE pagina %d: registros %d..%d (%d campos)" %
+             (sequence, first, first + count - 1, fields)]
+    for offset, values in enumerate(decode_series(page[PAGE_HEADER.size:], fields, count)):
+        # Registro do firmware: (min, max, media) por canal
+        channels = ["%s/%s/%s" % tuple(centi(v) for v in values[i:i + 3])
+                    for i in range(0, len(values) - 2, 3)]
+        lines.append("  minuto %d: %s" % (first + offset, " ".join(channels)))
+    return lines
+
+
+class Decoder:
+    def __init__(self, out):
+        self.out = out
+        self.channels = 1
+        self.history_next = None  # (próximo índice esperado, fim) do download em curso
+
+    def message(self, msg_type, payload):
+        if msg_type == MSG_INFO:
+            version, self.channels, interval, tiers, fields = struct.unpack("<BBHBB", payload)
+            return ["INFO versao %d, %d canais, varredura %d ms, %d niveis, arquivo %d campos" %
+                    (version, self.channels, interval, tiers, fields)]
+        if msg_type == MSG_SAMPLE:
+            (sequence,) = struct.unpack_from("<I", payload)
+            parts = []
+            for ch in range((len(payload) - 4) // 4):
+                adc_q4, temp = struct.unpack_from("<Hh", payload, 4 + 4 * ch)
+                parts.append("ch%d %s C (adc %.2f)" % (ch, centi(temp), adc_q4 / 16.0))
+            return ["SAMPLE %d: %s" % (sequence, ", ".join(parts))]
+        if msg_type == MSG_STATS:
+            ch, window, low, high, mean, stddev, count = struct.unpack("<BBhhhHI", payload)
+            name = WINDOWS[window] if window < len(WINDOWS) else str(window)
+            return ["STATS ch%d %s: min %s max %s media %s desvio %s (%d amostras)" %
+                    (ch, name, centi(low), centi(high), centi(mean), centi(stddev), count)]
+        if msg_type == MSG_ALERT:
+            sequence, ch, previous, current, temp = struct.unpack("<IBBBh", payload)
+            name = lambda a: ALERTS[a] if a < len(ALERTS) else str(a)
+            return ["ALERT %d ch%d: %s -> %s a %s C" %
+                    (sequence, ch, name(previous), name(current), centi(temp))]
+        if msg_type == MSG_HISTORY:
+            ch, tier, first, end = struct.unpack_from("<BBII", payload)
+            count = (len(payload) - 10) // 6
+            lines = ["HISTORY ch%d %s: registros %d..%d (idades %d..%d no pedido)" %
+                     (ch, TIERS[tier] if tier < len(TIERS) else tier, first, first + count - 1,
+                      end - first - 1, end - first - count)]
+            # Quadros seguidos se emendam pelo índice; um salto é perda no anel
+            expected = self.history_next[0] if self.history_next else None
+            if expected is not None and first != expected:
+                lines.append("  faltam os registros %d..%d (sobrescritos antes do envio)" %
+                             (expected, first - 1))
+            self.history_next = (first + count, end)
+            for i in range(count):
+                low, high, mean = struct.unpack_from("<hhh", payload, 10 + 6 * i)
+                lines.append("  %d: %s/%s/%s" % (first + i, centi(low), centi(high), centi(mean)))
+            return lines
+        if msg_type == MSG_ARCHIVE:
+            return describe_archive_page(payload)
+        if msg_type == MSG_END:
+            kind, frames = struct.unpack("<BI", payload)
+            lines = []
+            if kind == MSG_HISTORY and self.history_next and self.history_next[0] < self.history_next[1]:
+                lines.append("  download interrompido: faltam os registros %d..%d" %
+                             (self.history_next[0], self.history_next[1] - 1))
+            if kind == MSG_HISTORY:
+                self.history_next = None
+            return ["END %s, %d quadros" %
+                    ("historico" if kind == MSG_HISTORY else "arquivo", frames)] + lines
+        if msg_type == MSG_STATUS:
+            scans, ring, stream, rx = struct.unpack("<IIII", payload)
+            return ["STATUS %d varreduras, perdidas %d, quadros descartados %d, erros rx %d" %
+                    (scans, ring, stream, rx)]
+        if msg_type == MSG_MIRROR:
+            sequence, flags = struct.unpack_from("<HB", payload)
+            return ["MIRROR %d%s%s: %d bytes" % (sequence, " chave" if flags & 0x01 else "",
+                                                  " completo" if flags & 0x02 else "", len(payload))]
+        return ["tipo desconhecido 0x%02x (%d bytes)" % (msg_type, len(payload))]
+
+    def feed(self, data, pending):
+        pending += data
+        while True:
+            end = pending.find(b"\x00")
+            if end < 0:
+                return pending
+            encoded, pending = pending[:end], pending[end + 1:]
+            if not encoded:
+                continue
+            frame = frame_decode(encoded)
+            if frame is None:
+                # Texto anterior ao modo binário ou bytes perdidos
+                self.out.write("(%d bytes descartados)\n" % len(encoded))
+                continue
+            for line in self.message(*frame):
+                self.out.write(line + "\n")
+            self.out.flush()
+
+
+def open_port(path):
+    try:
+        import serial  # pyserial, se disponível
+        return serial.Serial(path, timeout=0.1)
+    except ImportError:
+        import termios
+        import tty
+        fd = os.open(path, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(fd)
+        termios.tcflush(fd, termios.TCIOFLUSH)
+        return os.fdopen(fd, "r+b", buffering=0)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("input", nargs="?", help="arquivo capturado (padrão: entrada padrão)")
+    parser.add_argument("--port", help="porta serial do dispositivo")
+    parser.add_argument("--history", nargs=2, type=int, metavar=("CANAL", "NIVEL"))
+    parser.add_argument("--archive", action="store_true")
+    args = parser.parse_args()
+
+    decoder = Decoder(sys.stdout)
+    if args.port:
+        stream = open_port(args.port)
+        stream.write(b"\nstream\n")
+        if args.history:
+            stream.write(frame_encode(CMD_HISTORY, struct.pack("<BB", *args.history)))
+        if args.archive:
+            stream.write(frame_encode(CMD_ARCHIVE))
+    elif args.input:
+        stream = open(args.input, "rb")
+    else:
+        stream = sys.stdin.buffer
+
+    pending = b""
+    try:
+        while True:
+            data = stream.read(4096) if not args.port else stream.read(256)
+            if not data:
+                if args.port:
+                    continue
+                break
+            pending = decoder.feed(data, pending)
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if args.port:
+            # Devolve a porta ao modo texto
+            stream.write(frame_encode(CMD_STOP))
+
+
+if __name__ == "__main__":
+    main()